@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+
+#include "gdal_geometry.h"
+#include "geos_utils.h"
+
+#include <string>
+
+#include <ogr_api.h>
+
+using namespace exactextract;
+
+static const char* ANTARCTICA_WKT =
+#include "resources/antarctica.wkt"
+  ;
+
+static const char* RUSSIA_WKT =
+#include "resources/russia.wkt"
+  ;
+
+static GEOSContextHandle_t
+geos_context()
+{
+    static GEOSContextHandle_t context = initGEOS_r(nullptr, nullptr);
+    return context;
+}
+
+static OGRGeometryH
+read_ogr(const char* wkt)
+{
+    std::string s(wkt);
+    char* ptr = s.data();
+    OGRGeometryH geom = nullptr;
+    OGR_G_CreateFromWkt(&ptr, nullptr, &geom);
+    return geom;
+}
+
+template<typename F>
+static void
+BM_OGRToGEOS(benchmark::State& state, const char* wkt, F convert)
+{
+    OGRGeometryH geom = read_ogr(wkt);
+
+    for (auto _ : state) {
+        auto converted = convert(geos_context(), geom);
+        benchmark::DoNotOptimize(converted);
+    }
+
+    state.SetItemsProcessed(state.iterations() * OGR_G_GetGeometryCount(geom));
+
+    OGR_G_DestroyGeometry(geom);
+}
+
+template<typename F>
+static void
+BM_GEOSToOGR(benchmark::State& state, const char* wkt, F convert)
+{
+    auto geom = GEOSGeom_read_r(geos_context(), wkt);
+
+    for (auto _ : state) {
+        OGRGeometryH converted = convert(geos_context(), geom.get());
+        benchmark::DoNotOptimize(converted);
+        OGR_G_DestroyGeometry(converted);
+    }
+
+    state.SetItemsProcessed(state.iterations() * GEOSGetNumGeometries_r(geos_context(), geom.get()));
+}
+
+static geom_ptr_r
+ogr_to_geos_direct(GEOSContextHandle_t context, OGRGeometryH geom)
+{
+    return ogr_to_geos(context, geom);
+}
+
+static OGRGeometryH
+geos_to_ogr_direct(GEOSContextHandle_t context, const GEOSGeometry* geom)
+{
+    return geos_to_ogr(context, geom);
+}
+
+#define CONVERSION_BENCHMARKS(NAME, WKT)                                                                        \
+    BENCHMARK_CAPTURE(BM_OGRToGEOS, NAME##_direct, WKT, ogr_to_geos_direct)->Unit(benchmark::kMillisecond);    \
+    BENCHMARK_CAPTURE(BM_OGRToGEOS, NAME##_wkb, WKT, ogr_to_geos_wkb)->Unit(benchmark::kMillisecond);          \
+    BENCHMARK_CAPTURE(BM_GEOSToOGR, NAME##_direct, WKT, geos_to_ogr_direct)->Unit(benchmark::kMillisecond);    \
+    BENCHMARK_CAPTURE(BM_GEOSToOGR, NAME##_wkb, WKT, geos_to_ogr_wkb)->Unit(benchmark::kMillisecond)
+
+CONVERSION_BENCHMARKS(antarctica, ANTARCTICA_WKT);
+CONVERSION_BENCHMARKS(russia, RUSSIA_WKT);
+
+BENCHMARK_MAIN();
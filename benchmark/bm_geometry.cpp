@@ -0,0 +1,224 @@
+#include <benchmark/benchmark.h>
+
+#include "floodfill.h"
+#include "geos_utils.h"
+#include "grid.h"
+#include "matrix.h"
+#include "raster_cell_intersection.h"
+#include "traversal_areas.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace exactextract;
+
+static const char* ANTARCTICA_WKT =
+#include "resources/antarctica.wkt"
+  ;
+
+static const char* RUSSIA_WKT =
+#include "resources/russia.wkt"
+  ;
+
+static const char* REGRESSION4_WKT =
+#include "resources/regression4.wkt"
+  ;
+
+static const char* REGRESSION6_WKT =
+#include "resources/regression6.wkt"
+  ;
+
+static constexpr double PI = 3.14159265358979323846;
+
+static GEOSContextHandle_t
+geos_context()
+{
+    static GEOSContextHandle_t context = initGEOS_r(nullptr, nullptr);
+    return context;
+}
+
+/// A geometry and a grid whose resolution is divided by the benchmark argument
+struct GeometryCase
+{
+    std::string wkt;
+    Box extent;
+    double resolution;
+
+    Grid<bounded_extent> grid(benchmark::State& state) const
+    {
+        double res = resolution / static_cast<double>(state.range(0));
+        return Grid<bounded_extent>(extent, res, res);
+    }
+
+    geom_ptr_r geometry() const
+    {
+        return GEOSGeom_read_r(geos_context(), wkt);
+    }
+};
+
+/// Regular polygon with `n` vertices approximating a circle
+static std::string
+circle_wkt(double x0, double y0, double r, std::size_t n)
+{
+    std::stringstream ss;
+    ss.precision(17);
+    ss << "POLYGON ((";
+    for (std::size_t i = 0; i <= n; i++) {
+        double theta = 2 * PI * static_cast<double>(i % n) / static_cast<double>(n);
+        ss << (i == 0 ? "" : ", ") << x0 + r * std::cos(theta) << " " << y0 + r * std::sin(theta);
+    }
+    ss << "))";
+    return ss.str();
+}
+
+/// Star with `n` spikes, whose inner vertices are at a fraction `inner` of the outer radius.
+/// The narrow spikes produce many cells that are traversed more than once.
+static std::string
+star_wkt(double x0, double y0, double r, std::size_t n, double inner)
+{
+    std::stringstream ss;
+    ss.precision(17);
+    ss << "POLYGON ((";
+    for (std::size_t i = 0; i <= 2 * n; i++) {
+        double theta = PI * static_cast<double>(i % (2 * n)) / static_cast<double>(n);
+        double ri = (i % 2 == 0) ? r : r * inner;
+        ss << (i == 0 ? "" : ", ") << x0 + ri * std::cos(theta) << " " << y0 + ri * std::sin(theta);
+    }
+    ss << "))";
+    return ss.str();
+}
+
+static const GeometryCase ANTARCTICA{ ANTARCTICA_WKT, { -180, -90, 180, 90 }, 1 };
+static const GeometryCase RUSSIA{ RUSSIA_WKT, { -180, -90, 180, 90 }, 1 };
+static const GeometryCase REGRESSION4{ REGRESSION4_WKT, { -166.84166666666667, 66.991666666666674, -152.625, 71.358333333333334 }, 0.0083333333333333332 };
+static const GeometryCase REGRESSION6{ REGRESSION6_WKT, { 145.925, -35.525, 147.375, -33.475 }, 0.05 };
+static const GeometryCase CIRCLE{ circle_wkt(50, 50, 40, 10000), { 0, 0, 100, 100 }, 1 };
+static const GeometryCase STAR{ star_wkt(50, 50, 40, 500, 0.2), { 0, 0, 100, 100 }, 1 };
+
+static void
+BM_RasterCellIntersection(benchmark::State& state, const GeometryCase& c)
+{
+    auto context = geos_context();
+    auto g = c.geometry();
+    auto grid = c.grid(state);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(raster_cell_intersection(grid, context, g.get()));
+    }
+}
+
+/// Traverse the cells crossed by the boundary of the geometry, computing the
+/// length of the boundary in each cell. Unlike a polygonal intersection, this
+/// involves no area calculation or flood fill.
+static void
+BM_TraverseCells(benchmark::State& state, const GeometryCase& c)
+{
+    auto context = geos_context();
+    auto g = c.geometry();
+    auto boundary = geos_ptr(context, GEOSBoundary_r(context, g.get()));
+    auto grid = c.grid(state);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(raster_cell_intersection(grid, context, boundary.get()));
+    }
+}
+
+/// Flood fill the cells not crossed by the boundary of the geometry, as is done
+/// after cell traversal when computing a polygonal intersection.
+static void
+BM_FloodFill(benchmark::State& state, const GeometryCase& c)
+{
+    auto context = geos_context();
+    auto g = c.geometry();
+    auto grid = c.grid(state);
+
+    auto coverage = raster_cell_intersection(grid, context, g.get());
+    Grid<bounded_extent> cropped = coverage.grid();
+
+    Matrix<float> fillable(coverage.rows(), coverage.cols());
+    for (std::size_t i = 0; i < fillable.rows(); i++) {
+        for (std::size_t j = 0; j < fillable.cols(); j++) {
+            float v = coverage(i, j);
+            fillable(i, j) = (v == 0 || v == 1) ? fill_values<float>::FILLABLE : v;
+        }
+    }
+
+    FloodFill ff(context, g.get(), cropped);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Matrix<float> arr(fillable.rows(), fillable.cols());
+        std::copy(fillable.data(), fillable.data() + fillable.rows() * fillable.cols(), arr.data());
+        state.ResumeTiming();
+
+        ff.flood(arr);
+        benchmark::DoNotOptimize(arr);
+    }
+}
+
+/// Compute the area to the left of `state.range(0)` zigzag lines, each with
+/// `state.range(1)` vertices, crossing a unit cell.
+static void
+BM_LeftHandArea(benchmark::State& state)
+{
+    auto context = geos_context();
+    Box box{ 0, 0, 1, 1 };
+
+    auto nlines = static_cast<std::size_t>(state.range(0));
+    auto nvertices = static_cast<std::size_t>(state.range(1));
+
+    std::vector<std::vector<Coordinate>> lines(nlines);
+    for (std::size_t i = 0; i < nlines; i++) {
+        double y0 = (static_cast<double>(i) + 0.5) / static_cast<double>(nlines);
+        double amplitude = 0.25 / static_cast<double>(nlines);
+
+        for (std::size_t k = 0; k < nvertices; k++) {
+            double x = static_cast<double>(k) / static_cast<double>(nvertices - 1);
+            double y = (k == 0 || k == nvertices - 1) ? y0 : y0 + (k % 2 == 0 ? amplitude : -amplitude);
+
+            // Alternate the direction of the lines so that they bound strips of the cell
+            lines[i].emplace_back(i % 2 == 0 ? x : 1 - x, y);
+        }
+    }
+
+    std::vector<const std::vector<Coordinate>*> coord_lists;
+    for (const auto& line : lines) {
+        coord_lists.push_back(&line);
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(left_hand_area(context, box, coord_lists));
+    }
+}
+
+// Arguments divide the resolution of the grid
+static void
+global_resolutions(benchmark::internal::Benchmark* b)
+{
+    b->Arg(1)->Arg(6)->Arg(12)->Unit(benchmark::kMillisecond);
+}
+
+static void
+local_resolutions(benchmark::internal::Benchmark* b)
+{
+    b->Arg(1)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond);
+}
+
+#define GEOMETRY_BENCHMARKS(NAME, CASE, RESOLUTIONS)                             \
+    BENCHMARK_CAPTURE(BM_RasterCellIntersection, NAME, CASE)->Apply(RESOLUTIONS); \
+    BENCHMARK_CAPTURE(BM_TraverseCells, NAME, CASE)->Apply(RESOLUTIONS);          \
+    BENCHMARK_CAPTURE(BM_FloodFill, NAME, CASE)->Apply(RESOLUTIONS)
+
+GEOMETRY_BENCHMARKS(antarctica, ANTARCTICA, global_resolutions);
+GEOMETRY_BENCHMARKS(russia, RUSSIA, global_resolutions);
+GEOMETRY_BENCHMARKS(regression4, REGRESSION4, local_resolutions);
+GEOMETRY_BENCHMARKS(regression6, REGRESSION6, local_resolutions);
+GEOMETRY_BENCHMARKS(circle, CIRCLE, local_resolutions);
+GEOMETRY_BENCHMARKS(star, STAR, local_resolutions);
+
+BENCHMARK(BM_LeftHandArea)->Args({ 1, 2 })->Args({ 1, 100 })->Args({ 10, 10 })->Args({ 50, 100 });
+
+BENCHMARK_MAIN();
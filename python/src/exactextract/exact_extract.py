@@ -22,6 +22,14 @@ from .raster import (
 )
 from .writer import GDALWriter, JSONWriter, PandasWriter, QGISWriter, Writer
 
+try:
+    from ._exactextract import GDALRaster as _GDALRaster
+    from ._exactextract import GDALRasterWrapper as _GDALRasterWrapper
+except ImportError:
+    # exactextract was built without GDAL
+    _GDALRaster = None
+    _GDALRasterWrapper = None
+
 __all__ = ["exact_extract"]
 
 
@@ -38,6 +46,71 @@ def make_raster_names(root: str, nbands: int) -> list:
             return [""]
 
 
+def native_raster_filename(rast) -> Optional[str]:
+    if isinstance(rast, (str, os.PathLike)):
+        return str(rast)
+
+    try:
+        from osgeo import gdal
+
+        if isinstance(rast, gdal.Dataset):
+            # Datasets without a description (e.g., in-memory datasets) cannot
+            # be reopened.
+            if not rast.GetDescription():
+                return None
+            # Make sure pending writes are visible when the file is reopened
+            rast.FlushCache()
+            return rast.GetDescription()
+    except ImportError:
+        pass
+
+    try:
+        import rasterio
+
+        if isinstance(rast, rasterio.DatasetReader):
+            return rast.name
+    except ImportError:
+        pass
+
+
+def prep_raster_native(rast, name_root=None) -> list:
+    """
+    Open a raster using the GDAL library linked into exactextract, so that
+    it can be read without calling into Python. Only inputs that can be
+    reopened by filename are handled; anything else is left to the other
+    loaders.
+    """
+    if _GDALRaster is None:
+        return None
+
+    filename = native_raster_filename(rast)
+    if not filename:
+        return None
+
+    try:
+        ds = _GDALRaster(filename)
+    except RuntimeError:
+        return None
+
+    nbands = ds.band_count()
+    if nbands == 0:
+        # Inputs with subdatasets are handled by the other loaders
+        return None
+
+    gt = ds.geotransform()
+    if gt is None or gt[2] != 0 or gt[4] != 0 or gt[5] >= 0:
+        # Leave the other loaders to report or handle unusual transforms
+        return None
+
+    names = make_raster_names(name_root, nbands)
+    sources = []
+    for i in range(nbands):
+        src = _GDALRasterWrapper(ds, i + 1)
+        src.set_name(names[i])
+        sources.append(src)
+    return sources
+
+
 def prep_raster_gdal(rast, name_root=None) -> list:
     try:
         # eagerly import gdal_array to avoid possible ImportError when reading raster data
@@ -136,7 +209,12 @@ def prep_raster(rast, name_root=None) -> list:
             sources = [prep_raster(src) for src in rast]
         return list(chain.from_iterable(sources))
 
-    for loader in (prep_raster_gdal, prep_raster_rasterio, prep_raster_xarray):
+    for loader in (
+        prep_raster_native,
+        prep_raster_gdal,
+        prep_raster_rasterio,
+        prep_raster_xarray,
+    ):
         sources = loader(rast, name_root)
         if sources:
             return sources
@@ -147,7 +225,7 @@ def prep_raster(rast, name_root=None) -> list:
 def prep_vec(vec):
     # TODO add some hooks to allow FeatureSource implementations
     # defined outside this library to handle other input types.
-    if isinstance(vec, FeatureSource):
+    if isinstance(vec, (FeatureSource, GeoPandasFeatureSource)):
         return vec
 
     if type(vec) is list and len(vec) > 0 and "geometry" in vec[0]:
@@ -216,11 +294,19 @@ def prep_ops(stats, values, weights=None, *, add_unique=False):
             # PythonOperation from inside prepare_operations. So we create a
             # set of dummy operations using a named stat and use properties of
             # these operations to create a set of PythonOperations.
+            batch_size = getattr(stat, "exactextract_batch_size", 0)
             nargs = stat.__code__.co_argcount
+            if batch_size:
+                # the last argument of a batched function receives the offsets
+                nargs -= 1
             if nargs == 3:
                 dummy_stat = "weighted_sum"
             elif nargs == 2:
                 dummy_stat = "count"
+            elif batch_size:
+                raise Exception(
+                    f"Batched summary operation {stat.__name__} must take 3 or 4 arguments"
+                )
             else:
                 raise Exception(
                     f"Summary operation {stat.__name__} must take 2 or 3 arguments"
@@ -234,6 +320,7 @@ def prep_ops(stats, values, weights=None, *, add_unique=False):
                             op.name.replace(dummy_stat, stat.__name__),
                             op.values,
                             op.weights,
+                            batch_size,
                         )
                     )
             except RuntimeError as e:
@@ -385,6 +472,11 @@ def exact_extract(
        ops: A list of :py:class:`Operation` objects, or strings that
             can be used to construct them (e.g., ``"mean"``, ``"quantile(q=0.33)"``).
             Check out :doc:`Available operations </operations>` for more information.
+            A Python function may also be provided; it is called for each feature
+            with read-only NumPy masked arrays of the cell values and coverage
+            fractions (and, if it accepts a third argument, the weights). These
+            arrays refer to memory that is reused after the function returns,
+            so they must be copied if they are to be retained.
        weights: An optional :py:class:`RasterSource` or filename for
             weights to be used in weighted operations.
        include_cols: An optional list of columns from the
@@ -426,7 +518,10 @@ def exact_extract(
        output_options: an optional dictionary of options passed to the :py:class:`writer.JSONWriter`, :py:class:`writer.PandasWriter`, or :py:class:`writer.GDALWriter`.
        progress: if `True`, a progress bar will be displayed. Alternatively, a
                  function may be provided that will be called with the completion fraction
-                 and a status message.
+                 and a status message. If the function accepts a third argument, it will
+                 also be provided with a ``ProgressEvent`` describing the number
+                 of features, cells and bytes processed, the rate of processing and the
+                 estimated time remaining.
     """
     rast = prep_raster(rast)
     weights = prep_raster(weights, name_root="weight")
@@ -457,6 +552,8 @@ def exact_extract(
     writer = prep_writer(output, vec.srs_wkt(), output_options)
 
     processor = Processor(vec, writer, ops, include_cols)
+    if isinstance(writer, PandasWriter):
+        writer.reserve(vec.count())
     if include_geom:
         processor.add_geom()
     processor.set_max_cells_in_memory(max_cells_in_memory)
@@ -473,17 +570,25 @@ def exact_extract(
 
                 bar = tqdm.tqdm(total=100)
 
-                def status(frac, message):
+                def status(frac, message, event):
                     pct = frac * 100
                     bar.update(pct - bar.n)
                     bar.set_description(message)
+                    bar.set_postfix_str(
+                        f"{event.cells_per_second / 1e6:0.2f}M cells/s", refresh=False
+                    )
                     if pct == 100:
                         bar.close()
 
             except ImportError:
 
-                def status(frac, message):
-                    print(f"[{frac * 100:0.1f}%] {message}")
+                def status(frac, message, event):
+                    eta = event.remaining
+                    eta = "" if eta is None else f", ETA {eta:0.0f}s"
+                    print(
+                        f"[{frac * 100:0.1f}%] {message} "
+                        f"({event.features_per_second:0.1f} features/s{eta})"
+                    )
 
             processor.set_progress_fn(status)
         else:
@@ -1,5 +1,6 @@
 import os
 
+from ._exactextract import ColumnarFeatureSource as _ColumnarFeatureSource
 from ._exactextract import Feature
 from ._exactextract import FeatureSource as _FeatureSource
 
@@ -196,24 +197,55 @@ class JSONFeature(Feature):
         return fields
 
 
-class GeoPandasFeatureSource(FeatureSource):
+class GeoPandasFeatureSource(_ColumnarFeatureSource):
     """
     A FeatureSource using GeoPandas GeoDataFrame to provide features.
+
+    Geometries are converted to WKB and attribute columns are copied in bulk,
+    without creating a Python object for each feature. Columns whose values
+    are not numbers (e.g., dates) are converted to strings. Missing values are
+    read as NaN.
     """
 
     def __init__(self, src):
-        super().__init__()
+        super().__init__(len(src.index))
         self.src = src
 
-    def count(self):
-        return len(self.src.index)
+        geom_col = src.geometry.name
 
-    def __iter__(self):
-        for f in self.src.iterfeatures():
-            yield JSONFeature(f)
+        for name in src.columns:
+            if name != geom_col:
+                self._add_series(str(name), src[name])
+
+        # consistent with the "id" of GeoDataFrame.iterfeatures()
+        if not self.has_column("id"):
+            self.add_column("id", src.index.astype(str).to_numpy(dtype=object))
+
+        self.set_wkb(src.geometry.to_wkb().to_numpy(dtype=object))
+
+    def _add_series(self, name, values):
+        import numpy as np
+
+        missing = values.isna().to_numpy()
+
+        # NumPy type of nullable extension types, e.g. Int64
+        dtype = getattr(values.dtype, "numpy_dtype", values.dtype)
+
+        if isinstance(dtype, np.dtype) and dtype.kind in "biuf":
+            if missing.any():
+                self.add_column(
+                    name, values.to_numpy(dtype=np.float64, na_value=np.nan)
+                )
+            else:
+                self.add_column(name, values.to_numpy(dtype=dtype))
+        else:
+            strings = values.astype(str).to_numpy(dtype=object)
+            strings[missing] = None
+            self.add_column(name, strings)
 
     def srs_wkt(self):
-        return self.src.crs.to_wkt()
+        if self.src.crs:
+            return self.src.crs.to_wkt()
 
 
 class QGISFeature(Feature):
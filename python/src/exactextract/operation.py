@@ -8,7 +8,7 @@ from ._exactextract import change_stat  # noqa: F401
 from ._exactextract import prepare_operations  # noqa: F401
 from .raster import RasterSource
 
-__all__ = ["Operation", "PythonOperation"]
+__all__ = ["Operation", "PythonOperation", "batched"]
 
 
 class Operation(_Operation):
@@ -62,6 +62,7 @@ class PythonOperation(_PythonOperation):
         field_name: str,
         raster: RasterSource,
         weights: Optional[RasterSource],
+        batch_size: int = 0,
     ):
         """
         Args:
@@ -71,9 +72,15 @@ class PythonOperation(_PythonOperation):
                       - pixel values from `raster` (masked array)
                       - cell coverage fractions
                       - pixel values from `weights` (masked array)
+                      If `batch_size` is nonzero, the function instead receives the
+                      concatenated arrays of up to `batch_size` features, followed by
+                      an additional argument of offsets into these arrays (see :py:func:`batched`).
             field_name: Name of the result field that is assigned by this Operation.
             raster: Raster to compute over.
             weights: Weight raster to use. Defaults to None.
+            batch_size: Maximum number of features whose results are computed by a
+                        single call to `function`, or zero to call `function`
+                        separately for each feature.
         """
 
         if raster is None:
@@ -83,6 +90,45 @@ class PythonOperation(_PythonOperation):
         # or without weights. This allows us to pass weights even if
         # they are unused, which is important to have weighted and
         # unweighted stats using the same common grid.
-        weighted = function.__code__.co_argcount == 3
+        weighted = function.__code__.co_argcount == (4 if batch_size else 3)
 
-        super().__init__(function, field_name, raster, weights, weighted)
+        super().__init__(function, field_name, raster, weights, weighted, batch_size)
+
+
+def batched(function: Optional[Callable] = None, *, size: int = 1024):
+    """
+    Mark a Python summary function as computing the results of many features in a single call
+
+    A batched function is called with the cells of up to ``size`` features,
+    concatenated into arrays of values, coverage fractions and (optionally)
+    weights, followed by an array of ``n + 1`` offsets such that the cells of
+    the ``i``-th feature are found at ``offsets[i]:offsets[i+1]``. It must
+    return a sequence of ``n`` results, one for each feature. This amortizes
+    the cost of calling into Python when there are many features with few cells.
+
+    Results for features that do not intersect any cells are ignored, as the
+    function would not have been called for them individually.
+
+    Can be used as ``@batched`` or ``@batched(size=4096)``.
+
+    Example:
+
+    .. code-block:: python
+
+        @batched
+        def py_sum(values, coverage, offsets):
+            n = len(offsets) - 1
+            feature = np.repeat(np.arange(n), np.diff(offsets))
+            return np.bincount(feature, weights=values.filled(0) * coverage, minlength=n)
+    """
+
+    def decorate(f):
+        if size < 1:
+            raise ValueError("Batch size must be positive")
+        f.exactextract_batch_size = size
+        return f
+
+    if function is None:
+        return decorate
+
+    return decorate(function)
@@ -2,6 +2,7 @@ from typing import List, Optional
 
 from ._exactextract import FeatureSequentialProcessor as _FeatureSequentialProcessor
 from ._exactextract import Processor  # noqa: F401
+from ._exactextract import ProgressEvent  # noqa: F401
 from ._exactextract import RasterSequentialProcessor as _RasterSequentialProcessor
 from .feature import FeatureSource
 from .operation import Operation
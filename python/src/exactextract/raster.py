@@ -1,3 +1,4 @@
+import collections
 import os
 
 import numpy as np
@@ -21,6 +22,15 @@ class RasterSource(_RasterSource):
     def __init__(self):
         super().__init__()
 
+    def block_size(self):
+        """
+        Return the dimensions (rows, cols) of the chunks in which the raster is
+        stored, or ``None`` if it is not stored in chunks. Reads are aligned
+        with the boundaries of the chunks where possible, so that a chunk does
+        not need to be read more than once.
+        """
+        return None
+
 
 class GDALRasterSource(RasterSource):
     """
@@ -280,15 +290,21 @@ class XArrayRasterSource(RasterSource):
 
     The rio-xarray extension is used to retrieve metadata such as the
     array extent, resolution, and spatial reference system.
+
+    If the ``DataArray`` is backed by Dask, reads are aligned with its chunks,
+    and computed chunks are cached so that the features intersecting a chunk
+    do not each cause it to be computed again.
     """
 
-    def __init__(self, ds, band_idx=1, *, name=None):
+    def __init__(self, ds, band_idx=1, *, name=None, cache_size=256 * 1024 * 1024):
         """
 
         Args:
             ds: An xarray ``DataArray`` or a path from which one can be read.
             band_idx: 1-based numerical index of band to read
             name: source name, to be used in generating field names for results
+            cache_size: maximum number of bytes of computed chunks to retain,
+                        if ``ds`` is backed by Dask
         """
         super().__init__()
 
@@ -308,6 +324,24 @@ class XArrayRasterSource(RasterSource):
         self.band_dim = self._band_dim(self.ds)
         self.bounds = self.ds.rio.bounds()
 
+        lats = self.ds[self.ds.rio.y_dim]
+        self.flipped = bool(len(lats) > 1 and lats[1] > lats[0])
+
+        self._blocks = None
+        if self.ds.chunks is not None:
+            band = self.ds
+            if self.band_dim is not None:
+                band = band.isel({self.band_dim: self.band_idx - 1})
+            band = band.transpose(self.ds.rio.y_dim, self.ds.rio.x_dim)
+
+            self._blocks = band.data.blocks
+            self._chunk_rows, self._chunk_cols = band.chunks
+            self._row_offsets = np.cumsum((0,) + self._chunk_rows)
+            self._col_offsets = np.cumsum((0,) + self._chunk_cols)
+            self._cache = collections.OrderedDict()
+            self._cache_bytes = 0
+            self._cache_size = cache_size
+
         if name:
             self.set_name(name)
 
@@ -338,16 +372,27 @@ class XArrayRasterSource(RasterSource):
     def nodata_value(self):
         return self.ds.rio.nodata
 
+    def block_size(self):
+        # Chunk boundaries are counted from the first row of the array, so
+        # they do not align with rows counted from the top of a flipped array.
+        if self._blocks is None or self.flipped:
+            return None
+
+        return self._chunk_rows[0], self._chunk_cols[0]
+
     def read_window(self, x0, y0, nx, ny):
         if nx == 0 or ny == 0:
             return np.array([[]], dtype=self.ds.dtype)
 
-        lats = self.ds[self.ds.rio.y_dim]
-        flipped = bool(len(lats) > 1 and lats[1] > lats[0])
+        flipped = self.flipped
 
         if flipped:
             y0 = self.ds.rio.height - y0 - ny
 
+        if self._blocks is not None:
+            ret = self._read_chunks(x0, y0, nx, ny)
+            return np.flipud(ret) if flipped else ret
+
         selection = {}
         if self.band_dim is not None:
             selection[self.band_dim] = self.ds[self.band_dim][self.band_idx - 1]
@@ -360,3 +405,48 @@ class XArrayRasterSource(RasterSource):
             ret = np.flipud(ret)
 
         return ret
+
+    def _read_chunks(self, x0, y0, nx, ny):
+        rows = range(
+            np.searchsorted(self._row_offsets, y0, side="right") - 1,
+            np.searchsorted(self._row_offsets, y0 + ny - 1, side="right"),
+        )
+        cols = range(
+            np.searchsorted(self._col_offsets, x0, side="right") - 1,
+            np.searchsorted(self._col_offsets, x0 + nx - 1, side="right"),
+        )
+        keys = [(i, j) for i in rows for j in cols]
+
+        # Compute all of the chunks that are not already cached at once, so
+        # that Dask can share the work of reading them.
+        missing = [k for k in keys if k not in self._cache]
+        if missing:
+            import dask
+
+            computed = dask.compute(*(self._blocks[k] for k in missing))
+            for k, chunk in zip(missing, computed):
+                self._cache[k] = chunk
+                self._cache_bytes += chunk.nbytes
+
+        ret = np.empty((ny, nx), dtype=self.ds.dtype)
+
+        for i, j in keys:
+            self._cache.move_to_end((i, j))
+            chunk = self._cache[(i, j)]
+
+            r0 = max(y0, self._row_offsets[i])
+            r1 = min(y0 + ny, self._row_offsets[i + 1])
+            c0 = max(x0, self._col_offsets[j])
+            c1 = min(x0 + nx, self._col_offsets[j + 1])
+
+            ret[r0 - y0 : r1 - y0, c0 - x0 : c1 - x0] = chunk[
+                r0 - self._row_offsets[i] : r1 - self._row_offsets[i],
+                c0 - self._col_offsets[j] : c1 - self._col_offsets[j],
+            ]
+
+        # Evict the least recently used chunks
+        while self._cache_bytes > self._cache_size and self._cache:
+            _, chunk = self._cache.popitem(last=False)
+            self._cache_bytes -= chunk.nbytes
+
+        return ret
@@ -2,6 +2,7 @@ import copy
 import os
 from typing import Mapping, Optional, Tuple
 
+from ._exactextract import NumPyWriter as _NumPyWriter
 from ._exactextract import Writer as _Writer
 from .feature import GDALFeature, JSONFeature, QGISFeature
 
@@ -120,53 +121,38 @@ class JSONWriter(Writer):
 
 
 class PandasWriter(Writer):
-    """Creates a (Geo)Pandas DataFrame"""
+    """Creates a (Geo)Pandas DataFrame
+
+    Values are stored in typed columns as features are written, and
+    converted to NumPy arrays only when the DataFrame is created.
+    """
 
     def __init__(self, *, srs_wkt=None):
         super().__init__()
 
-        self.fields = {}
-        self.geoms = []
-        self.srs_wkt = srs_wkt
-
-    def add_operation(self, op):
-        self.fields[op.name] = []
+        # Features are written to the columns without calling into Python
+        self._columns = _NumPyWriter()
+        self._forward_to(self._columns)
 
-    def add_column(self, col_name):
-        self.fields[col_name] = []
-
-    def add_geometry(self):
-        self.fields["geometry"] = []
-
-    def write(self, feature):
-        f = JSONFeature()
-        feature.copy_to(f)
-
-        props = f.feature["properties"]
+        self.srs_wkt = srs_wkt
 
-        for field in self.fields:
-            if field == "geometry" and "geometry" in f.feature:
-                import shapely
-
-                self.fields["geometry"].append(
-                    shapely.geometry.shape(f.feature["geometry"])
-                )
-            elif field == "id" and "id" in f.feature:
-                self.fields["id"].append(f.feature["id"])
-            elif field in props:
-                self.fields[field].append(props[field])
-            else:
-                self.fields[field].append(None)
+    def reserve(self, n):
+        """Reserve space in each column for ``n`` features"""
+        self._columns.reserve(n)
 
     def features(self):
-        if "geometry" in self.fields:
+        fields = dict(self._columns.columns())
+
+        if "geometry" in fields:
             import geopandas as gpd
 
-            return gpd.GeoDataFrame(self.fields, geometry="geometry", crs=self.srs_wkt)
+            fields["geometry"] = gpd.GeoSeries.from_wkb(fields["geometry"])
+
+            return gpd.GeoDataFrame(fields, geometry="geometry", crs=self.srs_wkt)
         else:
             import pandas as pd
 
-            return pd.DataFrame(self.fields, copy=False)
+            return pd.DataFrame(fields, copy=False)
 
 
 class QGISWriter(Writer):
@@ -11,13 +11,17 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <pybind11/numpy.h>
 #include <pybind11/operators.h>
 #include <pybind11/pybind11.h>
 
+#include "columnar_feature_source.h"
 #include "feature.h"
 #include "feature_source.h"
 #include "feature_source_bindings.h"
 
+#include <algorithm>
+
 namespace py = pybind11;
 
 namespace exactextract {
@@ -31,11 +35,13 @@ class PyFeatureSourceBase : public FeatureSource
 
     std::size_t count() const override
     {
+        py::gil_scoped_acquire gil;
         return py_count().cast<std::size_t>();
     }
 
     bool next() override
     {
+        py::gil_scoped_acquire gil;
         if (!m_initialized) {
             m_it = py_iter();
             m_initialized = true;
@@ -50,8 +56,15 @@ class PyFeatureSourceBase : public FeatureSource
         return true;
     }
 
+    void reset() override
+    {
+        // A new iterator is obtained from __iter__ when the next feature is read
+        m_initialized = false;
+    }
+
     const Feature& feature() const override
     {
+        py::gil_scoped_acquire gil;
         return m_feature.cast<const Feature&>();
     }
 
@@ -93,6 +106,75 @@ class PyFeatureSource : public PyFeatureSourceBase
     }
 };
 
+class PyColumnarFeatureSource : public ColumnarFeatureSource
+{
+  public:
+    explicit PyColumnarFeatureSource(std::size_t count)
+      : ColumnarFeatureSource(count)
+    {
+    }
+
+    void add_column_py(const std::string& name, py::array values)
+    {
+        char kind = values.dtype().kind();
+
+        if (kind == 'f') {
+            add_column(name, to_vector<double>(values));
+        } else if (kind == 'b' || ((kind == 'i' || kind == 'u') && values.itemsize() < 4) || (kind == 'i' && values.itemsize() == 4)) {
+            add_column(name, to_vector<std::int32_t>(values));
+        } else if (kind == 'i' || kind == 'u') {
+            add_column(name, to_vector<std::int64_t>(values));
+        } else {
+            // Missing values are indicated by None
+            std::vector<std::string> strings;
+            std::vector<bool> missing;
+            strings.reserve(static_cast<std::size_t>(values.size()));
+            missing.reserve(static_cast<std::size_t>(values.size()));
+            for (py::handle item : values.attr("flat")) {
+                missing.push_back(item.is_none());
+                strings.push_back(item.is_none() ? std::string() : item.cast<std::string>());
+            }
+            if (std::find(missing.begin(), missing.end(), true) == missing.end()) {
+                missing.clear();
+            }
+            add_column(name, std::move(strings), std::move(missing));
+        }
+    }
+
+    void set_wkb_py(py::iterable values)
+    {
+        // Keep references to the WKB buffers, which are borrowed rather than copied.
+        m_wkb_refs = py::list(values);
+
+        std::vector<std::string_view> wkb;
+        wkb.reserve(m_wkb_refs.size());
+        for (py::handle item : m_wkb_refs) {
+            if (item.is_none()) {
+                wkb.emplace_back();
+            } else {
+                char* buf;
+                Py_ssize_t sz;
+                if (PyBytes_AsStringAndSize(item.ptr(), &buf, &sz) != 0) {
+                    throw py::error_already_set();
+                }
+                wkb.emplace_back(buf, static_cast<std::size_t>(sz));
+            }
+        }
+
+        set_wkb(std::move(wkb));
+    }
+
+  private:
+    template<typename T>
+    static std::vector<T> to_vector(py::array values)
+    {
+        auto arr = py::array_t<T, py::array::c_style | py::array::forcecast>::ensure(values);
+        return std::vector<T>(arr.data(), arr.data() + arr.size());
+    }
+
+    py::list m_wkb_refs;
+};
+
 void
 bind_feature_source(py::module& m)
 {
@@ -107,5 +189,12 @@ bind_feature_source(py::module& m)
       .def("srs_wkt", &PyFeatureSourceBase::py_srs_wkt)
       // debug
       .def("feature", &PyFeatureSourceBase::feature);
+
+    py::class_<PyColumnarFeatureSource, FeatureSource>(m, "ColumnarFeatureSource")
+      .def(py::init<std::size_t>(), py::arg("count"))
+      .def("add_column", &PyColumnarFeatureSource::add_column_py, py::arg("name"), py::arg("values"))
+      .def("set_wkb", &PyColumnarFeatureSource::set_wkb_py, py::arg("values"))
+      .def("has_column", &PyColumnarFeatureSource::has_column)
+      .def("count", &PyColumnarFeatureSource::count);
 }
 }
@@ -22,6 +22,11 @@
 #include "raster_source.h"
 #include "utils.h"
 
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
 namespace py = pybind11;
 
 namespace exactextract {
@@ -34,10 +39,12 @@ class PythonOperation : public Operation
                     RasterSource* p_values,
                     RasterSource* p_weights,
                     bool call_with_weights,
+                    std::size_t batch_size = 0,
                     Operation::ArgMap args = {})
       : Operation("", p_name, p_values, p_weights, args)
       , m_function(fun)
       , m_call_with_weights(call_with_weights)
+      , m_batch_size(batch_size)
     {
         m_include_nodata = true;
         m_key += "|include_na";
@@ -72,33 +79,117 @@ class PythonOperation : public Operation
 
     virtual void set_result(const StatsRegistry::RasterStatsVariant& stats_variant, Feature& f_out) const override
     {
-        py::object result = std::visit([this](const auto& stats) -> py::object {
-            // TODO avoid array copies here?
-            // Review solutions at https://github.com/pybind/pybind11/issues/1042
-            py::array values = py::cast(stats.values());
+        py::gil_scoped_acquire gil;
+
+        std::visit([this, &stats_variant, &f_out](const auto& stats) {
             if (stats.values().empty()) {
-                return py::none();
+                return;
             }
 
-            auto numpy = py::module::import("numpy");
-            auto masked_array = numpy.attr("ma").attr("masked_array");
-            auto invert = numpy.attr("invert");
+            // The arrays passed to the function are read-only views of the cells
+            // stored in the RasterStats, which remain valid only for the duration
+            // of the call. The capsule serves as a non-owning base object so that
+            // NumPy does not copy the data.
+            py::capsule base(static_cast<const void*>(&stats_variant));
 
-            py::array mask = invert(py::cast(stats.values_defined()));
+            py::object values = masked(read_only_view(stats.values(), base), stats.values_defined(), base);
+            py::object coverage = read_only_view(stats.coverage_fractions(), base);
+            py::object weights;
 
             if (m_call_with_weights) {
-                return m_function(
-                  masked_array(values, mask),
-                  py::array(py::cast(stats.coverage_fractions())),
-                  masked_array(stats.weights(), invert(py::cast(stats.weights_defined()))));
+                weights = masked(read_only_view(stats.weights(), base), stats.weights_defined(), base);
             }
 
-            return m_function(
-              masked_array(values, mask),
-              py::array(py::cast(stats.coverage_fractions())));
+            py::object result = m_call_with_weights ? m_function(values, coverage, weights) : m_function(values, coverage);
+            store_result(result, f_out);
+
+            check_not_retained(base, { &result, &values, &coverage, &weights });
+        },
+                   stats_variant);
+    }
+
+    std::size_t batch_size() const override
+    {
+        return m_batch_size;
+    }
+
+    void add_to_batch(const StatsRegistry::RasterStatsVariant& stats_variant) const override
+    {
+        std::visit([this](const auto& stats) {
+            using T = typename std::remove_reference_t<decltype(stats.values())>::value_type;
+
+            // Values are accumulated as bytes because the type of the raster is not
+            // known until the first feature is added.
+            m_batch_format = py::format_descriptor<T>::format();
+            const auto* values = reinterpret_cast<const unsigned char*>(stats.values().data());
+            m_batch_values.insert(m_batch_values.end(), values, values + stats.values().size() * sizeof(T));
+            append(m_batch_values_defined, stats.values_defined());
+            append(m_batch_coverage, stats.coverage_fractions());
+
+            if (m_call_with_weights) {
+                append(m_batch_weights, stats.weights());
+                append(m_batch_weights_defined, stats.weights_defined());
+            }
         },
-                                       stats_variant);
+                   stats_variant);
+
+        m_batch_offsets.push_back(static_cast<std::int64_t>(m_batch_coverage.size()));
+    }
 
+    void set_batch_results(const std::vector<Feature*>& f_out) const override
+    {
+        py::gil_scoped_acquire gil;
+
+        const std::size_t n = m_batch_offsets.size() - 1;
+        if (f_out.size() != n) {
+            throw std::runtime_error("Number of features does not match the number of features added to the batch.");
+        }
+
+        {
+            // As for a single feature, the arrays are read-only views that are valid only
+            // for the duration of the call.
+            py::capsule base(static_cast<const void*>(this));
+
+            auto ncells = static_cast<py::ssize_t>(m_batch_coverage.size());
+            py::object values = masked(read_only(py::array(py::dtype(m_batch_format), { ncells }, m_batch_values.data(), base)), m_batch_values_defined, base);
+            py::object coverage = read_only_view(m_batch_coverage, base);
+            py::object offsets = read_only_view(m_batch_offsets, base);
+            py::object weights;
+
+            if (m_call_with_weights) {
+                weights = masked(read_only_view(m_batch_weights, base), m_batch_weights_defined, base);
+            }
+
+            py::object result = m_call_with_weights ? m_function(values, coverage, weights, offsets) : m_function(values, coverage, offsets);
+
+            if (py::len(result) != n) {
+                throw std::runtime_error("Python operation " + name + " returned " + std::to_string(py::len(result)) + " results for a batch of " + std::to_string(n) + " features.");
+            }
+
+            std::size_t i = 0;
+            for (py::handle item : result) {
+                // As when results are assigned individually, no result is assigned
+                // to features that do not intersect any cells.
+                if (m_batch_offsets[i + 1] > m_batch_offsets[i]) {
+                    store_result(py::reinterpret_borrow<py::object>(item), *f_out[i]);
+                }
+                i++;
+            }
+
+            check_not_retained(base, { &result, &values, &coverage, &weights, &offsets });
+        }
+
+        m_batch_values.clear();
+        m_batch_values_defined.clear();
+        m_batch_coverage.clear();
+        m_batch_weights.clear();
+        m_batch_weights_defined.clear();
+        m_batch_offsets.resize(1);
+    }
+
+  private:
+    void store_result(const py::object& result, Feature& f_out) const
+    {
         // TODO detect if f_out can handle a py::object directly?
         if (py::isinstance<py::int_>(result)) {
             f_out.set(name, result.cast<std::int64_t>());
@@ -120,14 +211,76 @@ class PythonOperation : public Operation
             f_out.set(name, result.cast<std::vector<double>>());
         } else if (py::isinstance<py::none>(result)) {
             // do nothing
+        } else if (py::isinstance(result, py::module::import("numpy").attr("integer"))) {
+            // NumPy scalars, e.g. the sum of an integer-typed array
+            f_out.set(name, result.cast<std::int64_t>());
+        } else if (py::isinstance(result, py::module::import("numpy").attr("floating"))) {
+            f_out.set(name, result.cast<double>());
+        } else if (result.is(py::module::import("numpy").attr("ma").attr("masked"))) {
+            // do nothing
         } else {
             throw std::runtime_error("Unhandled type returned from Python operation");
         }
     }
 
-  private:
+    static py::array read_only(py::array arr)
+    {
+        arr.attr("flags").attr("writeable") = false;
+        return arr;
+    }
+
+    template<typename T>
+    static py::array read_only_view(const std::vector<T>& v, py::handle base)
+    {
+        return read_only(py::array_t<T>(static_cast<py::ssize_t>(v.size()), v.data(), base));
+    }
+
+    static py::object masked(py::array data, const std::vector<std::uint8_t>& defined, py::handle base)
+    {
+        auto numpy = py::module::import("numpy");
+
+        // The flags are stored one byte per cell, so they can be viewed directly
+        // as booleans and inverted in a single pass.
+        py::array defined_view(py::dtype("bool"), { static_cast<py::ssize_t>(defined.size()) }, defined.data(), base);
+        py::array mask = numpy.attr("logical_not")(defined_view);
+
+        return numpy.attr("ma").attr("masked_array")(data, mask);
+    }
+
+    template<typename T>
+    static void append(std::vector<T>& dst, const std::vector<T>& src)
+    {
+        dst.insert(dst.end(), src.begin(), src.end());
+    }
+
+    /// Release the arguments passed to the function and make sure that it has not kept
+    /// a reference to them, since their data will be invalidated once the stored cells
+    /// are cleared. Every array viewing the stored cells, including the views that
+    /// NumPy creates from them (e.g., MaskedArray.data or numpy.asarray), holds a reference
+    /// to the base object, whereas the arguments themselves may have been discarded.
+    void check_not_retained(py::handle base, std::initializer_list<py::object*> args) const
+    {
+        for (auto* arg : args) {
+            *arg = py::object();
+        }
+
+        if (base.ref_count() > 1) {
+            throw std::runtime_error("Python operation " + name + " retained a reference to its arguments, which are only valid for the duration of the call. Use numpy.copy to preserve them.");
+        }
+    }
+
     py::function m_function;
     const bool m_call_with_weights;
+    const std::size_t m_batch_size;
+
+    // Cells of the features in the current batch, concatenated
+    mutable std::string m_batch_format;
+    mutable std::vector<unsigned char> m_batch_values;
+    mutable std::vector<std::uint8_t> m_batch_values_defined;
+    mutable std::vector<float> m_batch_coverage;
+    mutable std::vector<double> m_batch_weights;
+    mutable std::vector<std::uint8_t> m_batch_weights_defined;
+    mutable std::vector<std::int64_t> m_batch_offsets{ 0 };
 };
 
 void
@@ -144,7 +297,7 @@ bind_operation(py::module& m)
       .def_readonly("weights", &Operation::weights);
 
     py::class_<PythonOperation, Operation>(m, "PythonOperation")
-      .def(py::init<py::function, std::string, RasterSource*, RasterSource*, bool>());
+      .def(py::init<py::function, std::string, RasterSource*, RasterSource*, bool, std::size_t>());
 
     m.def("prepare_operations", py::overload_cast<const std::vector<std::string>&, const std::vector<RasterSource*>&, const std::vector<RasterSource*>&>(&prepare_operations));
 
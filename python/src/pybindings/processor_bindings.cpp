@@ -14,9 +14,13 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <sstream>
+
 #include "feature_sequential_processor.h"
 #include "feature_source.h"
 #include "output_writer.h"
+#include "processing_profile.h"
+#include "progress_event.h"
 #include "processor.h"
 #include "processor_bindings.h"
 #include "raster_sequential_processor.h"
@@ -28,20 +32,81 @@ namespace exactextract {
 void
 bind_processor(py::module& m)
 {
+    py::class_<ProgressEvent>(m, "ProgressEvent")
+      .def_readonly("fraction", &ProgressEvent::fraction)
+      .def_readonly("message", &ProgressEvent::message)
+      .def_readonly("features", &ProgressEvent::features)
+      .def_readonly("cells_read", &ProgressEvent::cells_read)
+      .def_readonly("bytes_read", &ProgressEvent::bytes_read)
+      .def_readonly("elapsed", &ProgressEvent::elapsed)
+      .def_property_readonly("features_per_second", &ProgressEvent::features_per_second)
+      .def_property_readonly("cells_per_second", &ProgressEvent::cells_per_second)
+      .def_property_readonly("bytes_per_second", &ProgressEvent::bytes_per_second)
+      .def_property_readonly("remaining", &ProgressEvent::remaining);
+
     py::class_<Processor>(m, "Processor")
       .def("add_operation", &Processor::add_operation)
       .def("add_col", &Processor::include_col)
       .def("add_geom", &Processor::include_geometry)
-      .def("process", &Processor::process)
+      .def("collect_profile", &Processor::collect_profile, py::arg("val"))
+      .def("explain", [](Processor& self) {
+          std::stringstream ss;
+          self.explain(ss);
+          return ss.str();
+      })
+      // Python sources, writers, operations and callbacks reacquire the GIL as needed.
+      .def("process", &Processor::process, py::call_guard<py::gil_scoped_release>())
+      .def("profile", [](const Processor& self) {
+          const ProcessingProfile& profile = self.profile();
+
+          py::dict ret;
+          for (std::size_t i = 0; i < ProcessingProfile::NUM_PHASES; i++) {
+              auto phase = static_cast<ProcessingProfile::Phase>(i);
+
+              py::dict times;
+              times["wall"] = profile.wall_seconds(phase);
+              times["cpu"] = profile.cpu_seconds(phase);
+
+              ret[ProcessingProfile::phase_name(phase)] = times;
+          }
+          ret["cells_read"] = profile.cells_read();
+          ret["bytes_read"] = profile.bytes_read();
+          ret["cells_covered"] = profile.cells_covered();
+          ret["features"] = profile.features();
+          ret["features_skipped"] = profile.features_skipped();
+
+          return ret;
+      })
       .def("set_grid_compat_tol", &Processor::set_grid_compat_tol)
       .def("set_max_cells_in_memory", &Processor::set_max_cells_in_memory, py::arg("n"))
+      .def("set_omit_features_outside", &Processor::set_omit_features_outside, py::arg("val"))
       .def("set_progress_fn", [](Processor& self, py::function fn) {
-          std::function<void(double, std::string_view)> wrapper = [fn](double frac, std::string_view message) {
-              fn(frac, message);
-          };
+          // Functions that accept a third argument also receive a ProgressEvent
+          // with the rate of processing.
+          bool accepts_event = true;
+          try {
+              py::module::import("inspect").attr("signature")(fn).attr("bind")(0.0, "", py::none());
+          } catch (const py::error_already_set&) {
+              accepts_event = false;
+          }
+
+          if (accepts_event) {
+              std::function<void(const ProgressEvent&)> wrapper = [fn](const ProgressEvent& event) {
+                  py::gil_scoped_acquire gil;
+                  fn(event.fraction, event.message, py::cast(event, py::return_value_policy::copy));
+              };
+
+              self.set_progress_fn(wrapper);
+          } else {
+              std::function<void(double, std::string_view)> wrapper = [fn](double frac, std::string_view message) {
+                  py::gil_scoped_acquire gil;
+                  fn(frac, message);
+              };
 
-          self.set_progress_fn(wrapper);
+              self.set_progress_fn(wrapper);
+          }
       })
+      .def("set_stream_cells", &Processor::set_stream_cells, py::arg("val"))
       .def("show_progress", &Processor::show_progress, py::arg("val"));
 
     py::class_<FeatureSequentialProcessor, Processor>(m, "FeatureSequentialProcessor")
@@ -13,11 +13,21 @@
 
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
+#include <optional>
 #include <utility>
 
 #include "raster_source.h"
 #include "raster_source_bindings.h"
 
+#ifdef EXACTEXTRACT_PYTHON_GDAL
+#include "gdal_raster_wrapper.h"
+
+#include <gdal.h>
+#include <mutex>
+#include <ogr_srs_api.h>
+#include <string>
+#endif
+
 namespace py = pybind11;
 
 namespace exactextract {
@@ -35,6 +45,13 @@ class NumPyRaster : public AbstractRaster<T>
     {
     }
 
+    ~NumPyRaster() override
+    {
+        // The raster may be destroyed by a Processor that has released the GIL.
+        py::gil_scoped_acquire gil;
+        m_array.release().dec_ref();
+    }
+
     T operator()(std::size_t row, std::size_t col) const override
     {
         return m_array_proxy(row, col);
@@ -83,6 +100,8 @@ class PyRasterSourceBase : public RasterSource
 
     RasterVariant read_box(const Box& box) override
     {
+        py::gil_scoped_acquire gil;
+
         auto cropped_grid = grid().crop(box);
 
         auto x0 = cropped_grid.col_offset(grid());
@@ -119,6 +138,8 @@ class PyRasterSourceBase : public RasterSource
     const Grid<bounded_extent>& grid() const override
     {
         if (m_grid == nullptr) {
+            py::gil_scoped_acquire gil;
+
             py::sequence grid_ext = extent();
 
             if (grid_ext.size() != 4) {
@@ -142,6 +163,29 @@ class PyRasterSourceBase : public RasterSource
         return *m_grid;
     }
 
+    std::pair<std::size_t, std::size_t> block_size() const override
+    {
+        if (!m_block_size.has_value()) {
+            py::gil_scoped_acquire gil;
+
+            py::object size = py_block_size();
+
+            if (size.is_none()) {
+                m_block_size = { 1, 1 };
+            } else {
+                py::sequence block_dims = size;
+
+                if (block_dims.size() != 2) {
+                    throw std::runtime_error("Expected 2 elements in block size");
+                }
+
+                m_block_size = { block_dims[0].cast<std::size_t>(), block_dims[1].cast<std::size_t>() };
+            }
+        }
+
+        return *m_block_size;
+    }
+
     virtual py::array read_window(int x0, int y0, int nx, int ny) const = 0;
 
     virtual py::object extent() const = 0;
@@ -155,8 +199,15 @@ class PyRasterSourceBase : public RasterSource
         return py::none();
     }
 
+    /// Returns the (rows, cols) of the chunks in which the raster is stored, or None
+    virtual py::object py_block_size() const
+    {
+        return py::none();
+    }
+
   private:
     mutable std::unique_ptr<Grid<bounded_extent>> m_grid;
+    mutable std::optional<std::pair<std::size_t, std::size_t>> m_block_size;
 };
 
 class PyRasterSource : public PyRasterSourceBase
@@ -187,6 +238,11 @@ class PyRasterSource : public PyRasterSourceBase
     {
         PYBIND11_OVERRIDE(py::str, PyRasterSourceBase, srs_wkt);
     }
+
+    py::object py_block_size() const override
+    {
+        PYBIND11_OVERRIDE_NAME(py::object, PyRasterSourceBase, "block_size", py_block_size);
+    }
 };
 
 void
@@ -203,7 +259,47 @@ bind_raster_source(py::module& m)
       .def("extent", &PyRasterSource::extent)
       .def("res", &PyRasterSource::res)
       .def("srs_wkt", &PyRasterSourceBase::srs_wkt)
+      .def("block_size", &PyRasterSourceBase::py_block_size)
       .def("nodata_value", &PyRasterSource::nodata_value)
       .def("read_window", &PyRasterSource::read_window);
+
+#ifdef EXACTEXTRACT_PYTHON_GDAL
+    // Rasters that are read by the GDAL library linked into exactextract,
+    // without calling back into Python.
+    py::class_<GDALRaster, std::shared_ptr<GDALRaster>>(m, "GDALRaster")
+      .def(py::init([](const std::string& dsn) {
+               static std::once_flag registered;
+               std::call_once(registered, GDALAllRegister);
+               return std::make_shared<GDALRaster>(dsn);
+           }),
+           py::arg("dsn"))
+      .def("band_count", [](GDALRaster& rast) { return GDALGetRasterCount(rast.get()); })
+      .def("geotransform", [](GDALRaster& rast) -> py::object {
+          double gt[6];
+          if (GDALGetGeoTransform(rast.get(), gt) != CE_None) {
+              return py::none();
+          }
+          return py::make_tuple(gt[0], gt[1], gt[2], gt[3], gt[4], gt[5]);
+      });
+
+    py::class_<GDALRasterWrapper, RasterSource>(m, "GDALRasterWrapper")
+      .def(py::init<std::shared_ptr<GDALRaster>, int>(), py::arg("dataset"), py::arg("band_idx"))
+      .def("srs_wkt", [](const GDALRasterWrapper& rast) -> py::object {
+          OGRSpatialReferenceH srs = rast.srs();
+          if (srs == nullptr) {
+              return py::none();
+          }
+
+          char* wkt = nullptr;
+          if (OSRExportToWkt(srs, &wkt) != OGRERR_NONE) {
+              CPLFree(wkt);
+              return py::none();
+          }
+
+          std::string ret(wkt);
+          CPLFree(wkt);
+          return py::str(ret);
+      });
+#endif
 }
 }
@@ -11,8 +11,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 
+#include <optional>
+
+#include "geos_utils.h"
+#include "map_feature.h"
 #include "operation.h"
 #include "output_writer.h"
 #include "writer_bindings.h"
@@ -23,32 +28,392 @@ namespace exactextract {
 class PyWriter : public OutputWriter
 {
   public:
+    /**
+     * @brief Forward all calls to an OutputWriter implemented in C++, such as a
+     *        NumPyWriter, so that a Python Writer can store its results without
+     *        calling into Python for each feature.
+     */
+    void forward_to(OutputWriter* target)
+    {
+        m_target = target;
+    }
+
     void add_operation(const Operation& op) override
     {
+        if (m_target) {
+            m_target->add_operation(op);
+            return;
+        }
         PYBIND11_OVERRIDE(void, OutputWriter, add_operation, op);
     }
 
     void add_column(const std::string& name) override
     {
+        if (m_target) {
+            m_target->add_column(name);
+            return;
+        }
         PYBIND11_OVERRIDE(void, OutputWriter, add_column, name);
     }
 
     void add_geometry() override
     {
+        if (m_target) {
+            m_target->add_geometry();
+            return;
+        }
         PYBIND11_OVERRIDE(void, OutputWriter, add_geometry);
     }
 
     void finish() override
     {
+        if (m_target) {
+            m_target->finish();
+            return;
+        }
         PYBIND11_OVERRIDE(void, OutputWriter, finish);
     }
 
     void write(const Feature& f) override
     {
+        if (m_target) {
+            m_target->write(f);
+            return;
+        }
+
+        py::gil_scoped_acquire gil;
+
         // https://github.com/pybind/pybind11/issues/2033#issuecomment-703177186
         py::object dummy = py::cast(f, py::return_value_policy::reference);
         PYBIND11_OVERLOAD_PURE(void, PyWriter, write, f);
     }
+
+  private:
+    OutputWriter* m_target = nullptr;
+};
+
+/**
+ * @brief An OutputWriter that stores the values of each field in a typed column,
+ *        without calling into Python until the columns are retrieved.
+ *
+ * Numeric columns are returned as NumPy arrays, and array-valued
+ * fields as NumPy arrays of objects. Columns with missing values, or
+ * with values of inconsistent types (e.g., strings and numbers), are
+ * returned as lists so that their type can be inferred by pandas.
+ */
+class NumPyWriter : public OutputWriter
+{
+  public:
+    void add_operation(const Operation& op) override
+    {
+        add_column(op.name);
+    }
+
+    void add_column(const std::string& name) override
+    {
+        m_columns.emplace_back(name, false);
+    }
+
+    void add_geometry() override
+    {
+        m_columns.emplace_back("geometry", true);
+    }
+
+    /// Reserve space for `n` features in each column
+    void reserve(std::size_t n)
+    {
+        m_reserve = n;
+        for (auto& col : m_columns) {
+            col.valid.reserve(n);
+        }
+    }
+
+    void write(const Feature& f) override
+    {
+        for (auto& col : m_columns) {
+            if (col.is_geometry) {
+                write_geometry(col, f.geometry());
+            } else if (has_field(f, col.name)) {
+                write_value(col, f, f.field_type(col.name));
+            } else {
+                write_missing(col);
+            }
+        }
+
+        m_rows++;
+    }
+
+    py::list columns() const
+    {
+        py::list ret;
+        for (const auto& col : m_columns) {
+            ret.append(py::make_tuple(col.name, column_values(col)));
+        }
+        return ret;
+    }
+
+  private:
+    struct Column
+    {
+        Column(std::string p_name, bool p_is_geometry)
+          : name(std::move(p_name))
+          , is_geometry(p_is_geometry)
+        {
+        }
+
+        std::string name;
+        bool is_geometry;
+        std::optional<Feature::ValueType> type;
+        std::vector<double> doubles;
+        std::vector<std::int64_t> ints;
+        std::vector<std::string> strings;
+        std::vector<Feature::FieldValue> arrays; // array values, or all values of a mixed column
+        std::vector<std::uint8_t> valid;
+        bool all_valid = true;
+        bool mixed = false;
+    };
+
+    static bool has_field(const Feature& f, const std::string& name)
+    {
+        if (const auto* mf = dynamic_cast<const MapFeature*>(&f)) {
+            return mf->map().find(name) != mf->map().end();
+        }
+
+        try {
+            f.field_type(name);
+            return true;
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    static bool is_array(Feature::ValueType type)
+    {
+        return type == Feature::ValueType::DOUBLE_ARRAY || type == Feature::ValueType::INT_ARRAY || type == Feature::ValueType::INT64_ARRAY;
+    }
+
+    // Set the type of a column when its first value is written, padding
+    // the storage for that type to account for previously missing values.
+    void set_type(Column& col, Feature::ValueType type) const
+    {
+        if (col.mixed) {
+            return;
+        }
+
+        if (type == Feature::ValueType::INT) {
+            type = Feature::ValueType::INT64;
+        }
+
+        if (!col.type.has_value()) {
+            col.type = type;
+
+            if (type == Feature::ValueType::DOUBLE) {
+                col.doubles.reserve(m_reserve);
+                col.doubles.resize(m_rows);
+            } else if (type == Feature::ValueType::INT64) {
+                col.ints.reserve(m_reserve);
+                col.ints.resize(m_rows);
+            } else if (type == Feature::ValueType::STRING) {
+                col.strings.reserve(m_reserve);
+                col.strings.resize(m_rows);
+            } else {
+                col.arrays.reserve(m_reserve);
+                col.arrays.resize(m_rows);
+            }
+
+            return;
+        }
+
+        if (col.type == type || (is_array(*col.type) && is_array(type))) {
+            return;
+        }
+
+        // mixed integer and floating-point values are stored as floating-point
+        if (col.type == Feature::ValueType::INT64 && type == Feature::ValueType::DOUBLE) {
+            col.doubles.assign(col.ints.begin(), col.ints.end());
+            col.ints.clear();
+            col.type = Feature::ValueType::DOUBLE;
+            return;
+        }
+        if (col.type == Feature::ValueType::DOUBLE && type == Feature::ValueType::INT64) {
+            return;
+        }
+
+        // Values of other types are stored without conversion, and returned as Python objects
+        set_mixed(col);
+    }
+
+    void set_mixed(Column& col) const
+    {
+        std::vector<Feature::FieldValue> values;
+        values.reserve(m_reserve);
+
+        switch (*col.type) {
+            case Feature::ValueType::DOUBLE:
+                values.assign(col.doubles.begin(), col.doubles.end());
+                break;
+            case Feature::ValueType::INT64:
+                values.assign(col.ints.begin(), col.ints.end());
+                break;
+            case Feature::ValueType::STRING:
+                values.assign(col.strings.begin(), col.strings.end());
+                break;
+            default:
+                values = std::move(col.arrays);
+        }
+
+        col.doubles.clear();
+        col.ints.clear();
+        col.strings.clear();
+        col.arrays = std::move(values);
+        col.mixed = true;
+    }
+
+    void write_value(Column& col, const Feature& f, Feature::ValueType type) const
+    {
+        set_type(col, type);
+
+        if (col.mixed) {
+            col.arrays.push_back(f.get(col.name));
+            col.valid.push_back(1);
+            return;
+        }
+
+        switch (*col.type) {
+            case Feature::ValueType::DOUBLE:
+                if (type == Feature::ValueType::DOUBLE) {
+                    col.doubles.push_back(f.get_double(col.name));
+                } else if (type == Feature::ValueType::INT) {
+                    col.doubles.push_back(static_cast<double>(f.get_int(col.name)));
+                } else {
+                    col.doubles.push_back(static_cast<double>(f.get_int64(col.name)));
+                }
+                break;
+            case Feature::ValueType::INT64:
+                col.ints.push_back(type == Feature::ValueType::INT ? f.get_int(col.name) : f.get_int64(col.name));
+                break;
+            case Feature::ValueType::STRING:
+                col.strings.push_back(f.get_string(col.name));
+                break;
+            default:
+                col.arrays.push_back(f.get(col.name));
+        }
+
+        col.valid.push_back(1);
+    }
+
+    void write_geometry(Column& col, const GEOSGeometry* geom) const
+    {
+        if (geom == nullptr) {
+            write_missing(col);
+            return;
+        }
+
+        set_type(col, Feature::ValueType::STRING);
+
+        std::size_t size;
+        unsigned char* wkb = GEOSGeomToWKB_buf_r(m_geos_context, geom, &size);
+        col.strings.emplace_back(reinterpret_cast<const char*>(wkb), size);
+        GEOSFree_r(m_geos_context, wkb);
+
+        col.valid.push_back(1);
+    }
+
+    static void write_missing(Column& col)
+    {
+        if (col.mixed) {
+            col.arrays.emplace_back();
+        } else if (col.type.has_value()) {
+            switch (*col.type) {
+                case Feature::ValueType::DOUBLE:
+                    col.doubles.emplace_back();
+                    break;
+                case Feature::ValueType::INT64:
+                    col.ints.emplace_back();
+                    break;
+                case Feature::ValueType::STRING:
+                    col.strings.emplace_back();
+                    break;
+                default:
+                    col.arrays.emplace_back();
+            }
+        }
+
+        col.valid.push_back(0);
+        col.all_valid = false;
+    }
+
+    py::object value(const Column& col, std::size_t i) const
+    {
+        if (!col.valid[i]) {
+            return py::none();
+        }
+
+        if (col.mixed) {
+            return to_python(col.arrays[i]);
+        }
+
+        switch (*col.type) {
+            case Feature::ValueType::DOUBLE:
+                return py::float_(col.doubles[i]);
+            case Feature::ValueType::INT64:
+                return py::int_(col.ints[i]);
+            case Feature::ValueType::STRING:
+                if (col.is_geometry) {
+                    return py::bytes(col.strings[i]);
+                }
+                return py::str(col.strings[i]);
+            default:
+                return to_python(col.arrays[i]);
+        }
+    }
+
+    static py::object to_python(const Feature::FieldValue& value)
+    {
+        return std::visit([](const auto& x) -> py::object {
+            using T = std::decay_t<decltype(x)>;
+            if constexpr (std::is_same_v<T, Feature::DoubleArray> || std::is_same_v<T, Feature::IntegerArray> || std::is_same_v<T, Feature::Integer64Array>) {
+                return py::array_t<typename T::value_type>(static_cast<py::ssize_t>(x.size), x.data);
+            } else {
+                return py::cast(x);
+            }
+        },
+                          value);
+    }
+
+    py::object column_values(const Column& col) const
+    {
+        if (col.type.has_value() && col.all_valid && !col.mixed) {
+            switch (*col.type) {
+                case Feature::ValueType::DOUBLE:
+                    return py::array_t<double>(static_cast<py::ssize_t>(col.doubles.size()), col.doubles.data());
+                case Feature::ValueType::INT64:
+                    return py::array_t<std::int64_t>(static_cast<py::ssize_t>(col.ints.size()), col.ints.data());
+                default:
+                    break;
+            }
+
+            if (is_array(*col.type)) {
+                py::object values = py::module::import("numpy").attr("empty")(m_rows, py::arg("dtype") = "object");
+                for (std::size_t i = 0; i < m_rows; i++) {
+                    values[py::int_(i)] = value(col, i);
+                }
+                return values;
+            }
+        }
+
+        py::list values;
+        for (std::size_t i = 0; i < m_rows; i++) {
+            values.append(col.type.has_value() ? value(col, i) : py::none());
+        }
+        return values;
+    }
+
+    inline static thread_local GEOSContextHandle_t m_geos_context = initGEOS_r(nullptr, nullptr);
+
+    std::vector<Column> m_columns;
+    std::size_t m_rows = 0;
+    std::size_t m_reserve = 0;
 };
 
 void
@@ -60,6 +425,21 @@ bind_writer(py::module& m)
       .def("add_geometry", &OutputWriter::add_geometry)
       .def("add_operation", &OutputWriter::add_operation)
       .def("finish", &OutputWriter::finish)
-      .def("write", &OutputWriter::write);
+      .def("write", &OutputWriter::write)
+      .def(
+        "_forward_to", [](OutputWriter& self, OutputWriter& target) {
+            auto* writer = dynamic_cast<PyWriter*>(&self);
+            if (writer == nullptr) {
+                throw std::runtime_error("Only a Python Writer can forward to another writer.");
+            }
+            writer->forward_to(&target);
+        },
+        py::arg("target"),
+        py::keep_alive<1, 2>());
+
+    py::class_<NumPyWriter, OutputWriter>(m, "NumPyWriter")
+      .def(py::init<>())
+      .def("reserve", &NumPyWriter::reserve, py::arg("n"))
+      .def("columns", &NumPyWriter::columns);
 }
 }
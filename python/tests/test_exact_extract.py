@@ -8,6 +8,7 @@ import pytest
 
 from exactextract import Operation, exact_extract
 from exactextract.feature import JSONFeatureSource
+from exactextract.operation import batched
 from exactextract.raster import NumPyRasterSource
 
 
@@ -291,6 +292,21 @@ def test_weighted_frac():
     pytest.xfail("missing placeholder results for weighted_frac_1 and weighted_frac_2")
 
 
+def test_histogram():
+    rast = NumPyRasterSource(np.arange(1, 10, dtype=np.float64).reshape(3, 3))
+    square = JSONFeatureSource(make_rect(0.5, 0.5, 2.5, 2.5))
+
+    results = exact_extract(
+        rast,
+        square,
+        ["histogram(edges=0:4:8:10)", "fixed=histogram(bins=3,min=1,max=10)"],
+    )
+
+    props = results[0]["properties"]
+    np.testing.assert_array_equal(props["histogram"], [1.0, 2.25, 0.75])
+    np.testing.assert_array_equal(props["fixed"], [1.0, 2.0, 1.0])
+
+
 def test_multisource():
     rast = [
         NumPyRasterSource(np.arange(1, 10).reshape(3, 3), name="a"),
@@ -989,6 +1005,47 @@ def test_error_rotated_inputs(tmp_path, rast_lib):
         exact_extract(rast, square, ["count"])
 
 
+@pytest.mark.parametrize("rast_lib", ("path", "gdal", "rasterio"))
+def test_native_gdal_raster(tmp_path, rast_lib):
+    from exactextract.exact_extract import _GDALRasterWrapper, prep_raster
+    from exactextract.raster import GDALRasterSource
+
+    if _GDALRasterWrapper is None:
+        if os.environ.get("EXACTEXTRACT_TEST_NATIVE_GDAL"):
+            pytest.fail("exactextract was expected to be built with GDAL")
+        pytest.skip("exactextract was built without GDAL")
+
+    raster_fname = str(tmp_path / "rast.tif")
+
+    create_gdal_raster(
+        raster_fname,
+        np.arange(16, dtype=np.int16).reshape(4, 4),
+        nodata=5,
+        scale=0.5,
+        offset=1,
+        crs="EPSG:4326",
+    )
+
+    if rast_lib == "path":
+        rast = raster_fname
+    else:
+        rast = open_with_lib(raster_fname, rast_lib)
+
+    sources = prep_raster(rast, name_root="x")
+    assert len(sources) == 1
+    assert isinstance(sources[0], _GDALRasterWrapper)
+    assert sources[0].name() == "x"
+    assert "4326" in sources[0].srs_wkt()
+
+    square = make_rect(0.5, 0.5, 3.5, 3.5)
+    stats = ["count", "sum", "min", "max"]
+
+    native = exact_extract(rast, square, stats)
+    python = exact_extract(GDALRasterSource(raster_fname, 1), square, stats)
+
+    assert native[0]["properties"] == python[0]["properties"]
+
+
 @pytest.mark.parametrize("dtype", (np.float64, np.float32, np.int32, np.int64))
 def test_types_preserved(dtype):
 
@@ -1388,6 +1445,149 @@ def test_custom_function():
     )
 
 
+@pytest.mark.parametrize("dtype", (np.int8, np.int32, np.float32, np.float64))
+def test_custom_function_array_views(dtype):
+    rast = NumPyRasterSource(np.arange(9, dtype=dtype).reshape(3, 3))
+    weights = NumPyRasterSource(np.ones((3, 3)))
+    square = make_rect(0.5, 0.5, 2.5, 2.5)
+
+    def check_args(values, coverage, weights):
+        assert values.dtype == dtype
+        assert coverage.dtype == np.float32
+        assert weights.dtype == np.float64
+
+        for arr in (values, coverage, weights):
+            assert not arr.flags.writeable
+            with pytest.raises(ValueError):
+                arr[0] = 1
+
+        return np.sum(values)
+
+    results = exact_extract(rast, square, check_args, weights=weights)
+
+    assert results[0]["properties"]["check_args"] == 36
+
+
+def test_custom_function_retains_arguments():
+    rast = NumPyRasterSource(np.arange(9).reshape(3, 3))
+    square = make_rect(0.5, 0.5, 2.5, 2.5)
+
+    retained = []
+
+    def keep_values(values, coverage):
+        retained.append(values)
+        return 1
+
+    with pytest.raises(RuntimeError, match="retained a reference"):
+        exact_extract(rast, square, keep_values)
+
+
+@pytest.mark.parametrize(
+    "derive",
+    (
+        lambda values: values.data,
+        lambda values: np.asarray(values),
+        lambda values: values.view(np.ndarray),
+        lambda values: values[1:],
+    ),
+)
+def test_custom_function_retains_view_of_arguments(derive):
+    rast = NumPyRasterSource(np.arange(9).reshape(3, 3))
+    square = make_rect(0.5, 0.5, 2.5, 2.5)
+
+    retained = []
+
+    def keep_view(values, coverage):
+        retained.append(derive(values))
+        return 1
+
+    with pytest.raises(RuntimeError, match="retained a reference"):
+        exact_extract(rast, square, keep_view)
+
+
+@pytest.mark.parametrize("keep", ("values", "data", "coverage", "offsets"))
+def test_custom_function_batched_retains_arguments(keep):
+    rast = NumPyRasterSource(np.arange(9).reshape(3, 3))
+    squares = [make_rect(0.5, 0.5, 2.5, 2.5, id=1), make_rect(0, 0, 1, 1, id=2)]
+
+    retained = []
+
+    @batched(size=2)
+    def keep_view(values, coverage, offsets):
+        retained.append(
+            {
+                "values": values,
+                "data": values.data,
+                "coverage": np.asarray(coverage)[1:],
+                "offsets": offsets.view(np.ndarray),
+            }[keep]
+        )
+        return [1] * (len(offsets) - 1)
+
+    with pytest.raises(RuntimeError, match="retained a reference"):
+        exact_extract(rast, squares, keep_view)
+
+
+@pytest.mark.parametrize("strategy", ("feature-sequential", "raster-sequential"))
+def test_custom_function_batched(strategy):
+    rast = NumPyRasterSource(np.arange(16, dtype=np.float64).reshape(4, 4), nodata=5)
+    weights = NumPyRasterSource(np.full((4, 4), 2.0))
+
+    squares = [
+        make_rect(i, j, i + 1.5, j + 1.5, id=4 * i + j)
+        for i in range(3)
+        for j in range(3)
+    ]
+    squares.append(make_rect(10, 10, 11, 11, id=100))  # outside raster
+
+    batch_sizes = []
+
+    def py_weighted_sum(values, coverage, weights):
+        return np.ma.sum(values * coverage * weights)
+
+    @batched(size=4)
+    def py_batched_weighted_sum(values, coverage, weights, offsets):
+        batch_sizes.append(len(offsets) - 1)
+        return [
+            np.ma.sum(values[a:b] * coverage[a:b] * weights[a:b])
+            for a, b in zip(offsets[:-1], offsets[1:])
+        ]
+
+    results = exact_extract(
+        rast,
+        squares,
+        [py_weighted_sum, py_batched_weighted_sum],
+        weights=weights,
+        include_cols=["id"],
+        strategy=strategy,
+    )
+
+    assert batch_sizes == [4, 4, 2]
+    assert sorted(f["id"] for f in results) == sorted(f["id"] for f in squares)
+
+    for f in results:
+        props = f["properties"]
+        if f["id"] == 100:
+            assert props.get("py_batched_weighted_sum") is None
+            assert props.get("py_weighted_sum") is None
+        else:
+            assert props["py_batched_weighted_sum"] == pytest.approx(
+                props["py_weighted_sum"]
+            )
+
+
+def test_custom_function_batched_wrong_length():
+    rast = NumPyRasterSource(np.arange(9).reshape(3, 3))
+    squares = [make_rect(0.5, 0.5, 2.5, 2.5), make_rect(0, 0, 1, 1)]
+
+    @batched
+    def one_result(values, coverage, offsets):
+        return [1]
+
+    with pytest.raises(RuntimeError, match="returned 1 results for a batch of 2"):
+        exact_extract(rast, squares, one_result)
+
+
 @pytest.mark.parametrize("weighted", (False, True))
 def test_custom_function_nodata(weighted):
     rast = NumPyRasterSource(np.arange(9).reshape(3, 3), nodata=7)
@@ -1404,11 +1604,12 @@ def test_custom_function_nodata(weighted):
     def py_get_weighted_values(v, c, w):
         nonlocal values, coverage, weights
 
-        values = v
-        coverage = c
+        # The arguments are only valid for the duration of the call
+        values = v.copy()
+        coverage = c.copy()
 
         if w is not None:
-            weights = w
+            weights = w.copy()
 
     if weighted:
         results = exact_extract(
@@ -1661,3 +1862,33 @@ def test_gdal_multi_variable(multidim_nc, libname):
             "t2m_band_1_count": 4.0,
         }
     )
+
+
+def test_concurrent_calls():
+    from concurrent.futures import ThreadPoolExecutor
+
+    rast = NumPyRasterSource(np.arange(10000, dtype=np.float64).reshape(100, 100))
+
+    squares = [
+        make_rect(i, i, i + 10.5, i + 10.5, id=i, properties={"n": i})
+        for i in range(0, 80, 4)
+    ]
+
+    def run(strategy):
+        return exact_extract(
+            rast,
+            JSONFeatureSource(squares),
+            ["mean", "count", "quantile(q=0.25)"],
+            include_cols="n",
+            strategy=strategy,
+            progress=lambda frac, message: None,
+        )
+
+    strategies = ["feature-sequential", "raster-sequential"] * 4
+
+    expected = [run(s) for s in strategies]
+
+    with ThreadPoolExecutor(max_workers=4) as executor:
+        results = list(executor.map(run, strategies))
+
+    assert results == expected
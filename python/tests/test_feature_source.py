@@ -1,4 +1,10 @@
-from exactextract.feature import GDALFeatureSource, JSONFeatureSource
+import pytest
+
+from exactextract.feature import (
+    GDALFeatureSource,
+    GeoPandasFeatureSource,
+    JSONFeatureSource,
+)
 
 
 def test_gdal_feature_source():
@@ -41,3 +47,95 @@ def test_python_feature_source():
 
     assert fs.count() == 5
     assert fs.count() == 5
+
+
+def test_geopandas_feature_source():
+    gpd = pytest.importorskip("geopandas")
+    pd = pytest.importorskip("pandas")
+    shapely = pytest.importorskip("shapely")
+
+    import numpy as np
+
+    from exactextract import exact_extract
+    from exactextract.raster import NumPyRasterSource
+
+    gdf = gpd.GeoDataFrame(
+        {
+            "name": ["a", "b"],
+            "value": [1.5, 2.5],
+            "n": np.array([3, 4], dtype=np.int64),
+            "date": pd.to_datetime(["2024-01-01", "2024-01-02"]),
+        },
+        geometry=[shapely.box(0, 0, 1, 1), shapely.box(1, 1, 3, 3)],
+    )
+
+    fs = GeoPandasFeatureSource(gdf)
+
+    assert fs.count() == 2
+    assert fs.has_column("name")
+    assert fs.has_column("value")
+    assert fs.has_column("n")
+    assert fs.has_column("id")
+    assert fs.has_column("date")
+
+    rast = NumPyRasterSource(np.arange(9, dtype=np.float64).reshape(3, 3))
+
+    results = exact_extract(
+        rast, fs, "count", include_cols=["name", "value", "n", "date", "id"]
+    )
+
+    assert [f["properties"] for f in results] == [
+        {
+            "name": "a",
+            "value": 1.5,
+            "n": 3,
+            "date": "2024-01-01",
+            "id": "0",
+            "count": 1.0,
+        },
+        {
+            "name": "b",
+            "value": 2.5,
+            "n": 4,
+            "date": "2024-01-02",
+            "id": "1",
+            "count": 4.0,
+        },
+    ]
+
+
+def test_geopandas_feature_source_missing_values():
+    gpd = pytest.importorskip("geopandas")
+    pd = pytest.importorskip("pandas")
+    shapely = pytest.importorskip("shapely")
+
+    import math
+
+    import numpy as np
+
+    from exactextract import exact_extract
+    from exactextract.raster import NumPyRasterSource
+
+    gdf = gpd.GeoDataFrame(
+        {
+            "name": ["a", None],
+            "n": pd.array([3, None], dtype="Int64"),
+            "flag": pd.array([None, True], dtype="boolean"),
+        },
+        geometry=[shapely.box(0, 0, 1, 1), shapely.box(1, 1, 3, 3)],
+    )
+
+    fs = GeoPandasFeatureSource(gdf)
+
+    rast = NumPyRasterSource(np.arange(9, dtype=np.float64).reshape(3, 3))
+
+    results = exact_extract(rast, fs, "count", include_cols=["name", "n", "flag"])
+    a, b = [f["properties"] for f in results]
+
+    assert a["name"] == "a"
+    assert a["n"] == 3
+    assert math.isnan(a["flag"])
+
+    assert math.isnan(b["name"])
+    assert math.isnan(b["n"])
+    assert b["flag"] == 1
@@ -54,6 +54,35 @@ def test_progress(np_raster_source, square_features):
     assert fracs[-1] == 1.0
 
 
+def test_progress_event(np_raster_source, square_features):
+    ops = [
+        Operation("count", "count", np_raster_source),
+    ]
+    writer = JSONWriter()
+
+    fs = JSONFeatureSource(square_features)
+
+    events = []
+
+    def status(frac, message, event):
+        assert event.fraction == frac
+        assert event.message == message
+        events.append(event)
+
+    processor = FeatureSequentialProcessor(fs, writer, ops)
+    processor.set_progress_fn(status)
+    processor.show_progress(True)
+    processor.process()
+
+    assert len(events) == len(square_features)
+    assert [e.features for e in events] == list(range(len(square_features)))
+    assert events[-1].cells_read > 0
+    assert events[-1].bytes_read > 0
+    assert events[-1].elapsed >= 0
+    assert events[-1].cells_per_second >= 0
+    assert events[-1].remaining == 0
+
+
 def test_progress_tqdm(np_raster_source, square_features):
     tqdm = pytest.importorskip("tqdm")
 
@@ -79,3 +108,32 @@ def test_progress_tqdm(np_raster_source, square_features):
     assert bar.n == 0
     processor.process()
     assert bar.n == 100
+
+
+@pytest.mark.parametrize(
+    "Processor", (FeatureSequentialProcessor, RasterSequentialProcessor)
+)
+def test_profile(Processor, np_raster_source, square_features):
+    ops = [
+        Operation("count", "count", np_raster_source),
+    ]
+    writer = JSONWriter()
+
+    fs = JSONFeatureSource(square_features)
+
+    processor = Processor(fs, writer, ops)
+    processor.collect_profile(True)
+    processor.process()
+
+    profile = processor.profile()
+
+    for phase in ("read_features", "read_rasters", "coverage", "stats", "write"):
+        assert profile[phase]["wall"] >= 0
+        assert profile[phase]["cpu"] >= 0
+        assert profile[phase]["wall"] <= profile["total"]["wall"]
+
+    assert profile["features"] == len(square_features)
+    assert profile["features_skipped"] == 0
+    assert profile["cells_read"] > 0
+    assert profile["bytes_read"] >= profile["cells_read"]
+    assert profile["cells_covered"] > 0
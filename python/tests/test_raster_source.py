@@ -103,3 +103,38 @@ def test_scaled_raster(scaled_temperature, Source):
     window = src.read_window(0, 0, 2, 2)
 
     assert window[0, 0] == pytest.approx(278.2057, rel=1e-3)
+
+
+@pytest.mark.parametrize("cache_size", (1000, 1024 * 1024))
+@pytest.mark.parametrize("flipped", (False, True))
+def test_xarray_dask_chunks(flipped, cache_size):
+    xarray = pytest.importorskip("xarray")
+    pytest.importorskip("rioxarray")
+    pytest.importorskip("dask")
+
+    data = np.arange(20 * 30, dtype=np.int32).reshape(20, 30)
+    x = np.arange(0.5, 30)
+    y = np.arange(19.5, 0, -1)
+
+    if flipped:
+        da = xarray.DataArray(
+            np.flipud(data), dims=("y", "x"), coords={"y": y[::-1], "x": x}
+        )
+    else:
+        da = xarray.DataArray(data, dims=("y", "x"), coords={"y": y, "x": x})
+
+    ref = XArrayRasterSource(da)
+    src = XArrayRasterSource(da.chunk({"y": 7, "x": 8}), cache_size=cache_size)
+
+    assert ref.block_size() is None
+    if flipped:
+        assert src.block_size() is None
+    else:
+        assert src.block_size() == (7, 8)
+
+    np.testing.assert_array_equal(src.read_window(0, 0, 30, 20), data)
+
+    for window in ((5, 3, 10, 9), (7, 6, 1, 1), (29, 19, 1, 1), (8, 7, 8, 7)):
+        np.testing.assert_array_equal(
+            src.read_window(*window), ref.read_window(*window)
+        )
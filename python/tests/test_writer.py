@@ -1,10 +1,17 @@
 import json
+import math
 
 import pytest
 
 from exactextract import Operation
 from exactextract.feature import JSONFeature
-from exactextract.writer import GDALWriter, JSONWriter, PandasWriter, QGISWriter
+from exactextract.writer import (
+    GDALWriter,
+    JSONWriter,
+    PandasWriter,
+    QGISWriter,
+    Writer,
+)
 
 
 @pytest.fixture()
@@ -143,6 +150,112 @@ def test_pandas_writer(np_raster_source, point_features):
     assert list(df["mean_result"]) == [9, 4]
 
 
+def test_pandas_writer_column_types(np_raster_source):
+    np = pytest.importorskip("numpy")
+    pytest.importorskip("pandas")
+
+    w = PandasWriter()
+
+    w.add_column("name")
+    w.add_operation(Operation("mean", "mean", np_raster_source))
+    w.add_operation(Operation("count", "count", np_raster_source))
+    w.add_operation(Operation("values", "values", np_raster_source))
+    w.add_operation(Operation("mode", "mode", np_raster_source))
+
+    properties = [
+        {"name": "a", "mean": 1, "count": 3, "values": np.array([1.0, 2.0])},
+        {"name": "b", "mean": 2.5, "count": 4, "values": np.array([3.0])},
+        {"name": "c", "mean": 3.5, "count": 5, "values": np.array([], np.float64)},
+    ]
+
+    for props in properties:
+        w.write(JSONFeature({"properties": props}))
+
+    df = w.features()
+
+    assert list(df.columns) == ["name", "mean", "count", "values", "mode"]
+
+    assert df["name"].dtype == object
+    assert list(df["name"]) == ["a", "b", "c"]
+
+    # integer and floating-point values are combined
+    assert df["mean"].dtype == np.float64
+    assert list(df["mean"]) == [1.0, 2.5, 3.5]
+
+    assert df["count"].dtype == np.int64
+    assert list(df["count"]) == [3, 4, 5]
+
+    # array-valued fields are stored as objects
+    assert df["values"].dtype == object
+    np.testing.assert_array_equal(df["values"][0], [1.0, 2.0])
+    np.testing.assert_array_equal(df["values"][1], [3.0])
+    assert len(df["values"][2]) == 0
+
+    # missing values
+    assert list(df["mode"]) == [None, None, None]
+
+
+def test_pandas_writer_missing_values(np_raster_source):
+    pytest.importorskip("pandas")
+
+    w = PandasWriter()
+
+    w.add_operation(Operation("mean", "mean", np_raster_source))
+    w.add_operation(Operation("mode", "mode", np_raster_source))
+
+    w.write(JSONFeature({"properties": {"mean": 1.5}}))
+    w.write(JSONFeature({"properties": {"mean": 2.5, "mode": 7}}))
+
+    df = w.features()
+
+    assert list(df["mean"]) == [1.5, 2.5]
+    assert math.isnan(df["mode"][0])
+    assert df["mode"][1] == 7
+
+
+def test_pandas_writer_mixed_types(np_raster_source):
+    pytest.importorskip("pandas")
+
+    w = PandasWriter()
+
+    w.add_column("name")
+    w.add_operation(Operation("mean", "mean", np_raster_source))
+
+    w.write(JSONFeature({"properties": {"name": 1, "mean": 1.5}}))
+    w.write(JSONFeature({"properties": {"name": "b"}}))
+    w.write(JSONFeature({"properties": {"name": 3.5, "mean": "x"}}))
+
+    df = w.features()
+
+    assert df["name"].dtype == object
+    assert list(df["name"]) == [1, "b", 3.5]
+    assert list(df["mean"]) == [1.5, None, "x"]
+
+
+def test_pandas_writer_is_writer():
+    w = PandasWriter()
+
+    assert isinstance(w, Writer)
+
+
+def test_geopandas_writer(point_features):
+    pytest.importorskip("geopandas")
+
+    w = PandasWriter()
+
+    w.add_column("type")
+    w.add_geometry()
+
+    for f in point_features:
+        w.write(f)
+
+    df = w.features()
+
+    assert list(df["type"]) == ["apple", "pear"]
+    assert list(df.geometry.x) == [3, 2]
+    assert list(df.geometry.y) == [8, 2]
+
+
 def test_qgis_writer(np_raster_source, point_features):
     qgis_core = pytest.importorskip("qgis.core")
 
@@ -0,0 +1,97 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+
+#include "coordinate.h"
+
+namespace exactextract {
+
+/**
+ * @brief An affine transformation from the coordinates (u, v) of a Grid to the
+ *        coordinates (x, y) of the features being processed, with coefficients
+ *        in the order used by a GDAL geotransform:
+ *
+ *        x = c[0] + c[1] * u + c[2] * v
+ *        y = c[3] + c[4] * u + c[5] * v
+ */
+class AffineTransform
+{
+  public:
+    explicit AffineTransform(const std::array<double, 6>& c)
+      : m_c(c)
+    {
+    }
+
+    /**
+     * @brief Construct the transformation for a raster with the geotransform `gt`
+     *        and `rows` rows, whose Grid is defined in pixel space: `u` is the column
+     *        offset and `v` is the number of rows above the bottom of the raster.
+     */
+    static AffineTransform from_geotransform(const double* gt, std::size_t rows)
+    {
+        const auto ny = static_cast<double>(rows);
+
+        return AffineTransform({ gt[0] + ny * gt[2], gt[1], -gt[2], gt[3] + ny * gt[5], gt[4], -gt[5] });
+    }
+
+    Coordinate apply(double u, double v) const
+    {
+        return { m_c[0] + m_c[1] * u + m_c[2] * v,
+                 m_c[3] + m_c[4] * u + m_c[5] * v };
+    }
+
+    double determinant() const
+    {
+        return m_c[1] * m_c[5] - m_c[2] * m_c[4];
+    }
+
+    AffineTransform inverse() const
+    {
+        double det = determinant();
+        if (det == 0) {
+            throw std::runtime_error("Affine transformation is not invertible.");
+        }
+
+        double a = m_c[5] / det;
+        double b = -m_c[2] / det;
+        double d = -m_c[4] / det;
+        double e = m_c[1] / det;
+
+        return AffineTransform({ -(a * m_c[0] + b * m_c[3]), a, b, -(d * m_c[0] + e * m_c[3]), d, e });
+    }
+
+    const std::array<double, 6>& coefficients() const
+    {
+        return m_c;
+    }
+
+    bool operator==(const AffineTransform& other) const
+    {
+        return m_c == other.m_c;
+    }
+
+    bool operator!=(const AffineTransform& other) const
+    {
+        return !(*this == other);
+    }
+
+  private:
+    std::array<double, 6> m_c;
+};
+
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "binned_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace exactextract {
+
+BinnedHistogram::BinnedHistogram(std::vector<double> edges)
+  : m_edges(std::move(edges))
+{
+    if (m_edges.size() < 2) {
+        throw std::runtime_error("Histogram must have at least two bin edges.");
+    }
+
+    for (std::size_t i = 0; i < m_edges.size(); i++) {
+        if (!std::isfinite(m_edges[i])) {
+            throw std::runtime_error("Histogram bin edges must be finite.");
+        }
+        if (i > 0 && m_edges[i] <= m_edges[i - 1]) {
+            throw std::runtime_error("Histogram bin edges must be strictly increasing.");
+        }
+    }
+
+    m_sum_ci.resize(m_edges.size() - 1);
+    m_sum_ciwi.resize(m_edges.size() - 1);
+}
+
+BinnedHistogram
+BinnedHistogram::fixed_width(double min, double max, std::size_t bins)
+{
+    if (bins == 0) {
+        throw std::runtime_error("Histogram must have at least one bin.");
+    }
+    if (!std::isfinite(min) || !std::isfinite(max) || max <= min) {
+        throw std::runtime_error("Histogram range must be finite, with max greater than min.");
+    }
+
+    double width = (max - min) / static_cast<double>(bins);
+
+    std::vector<double> edges(bins + 1);
+    for (std::size_t i = 0; i < bins; i++) {
+        edges[i] = min + static_cast<double>(i) * width;
+    }
+    edges[bins] = max;
+
+    BinnedHistogram ret(std::move(edges));
+    ret.m_width = width;
+    return ret;
+}
+
+std::optional<std::size_t>
+BinnedHistogram::bin(double x) const
+{
+    // Also rejects NaN
+    if (!(x >= m_edges.front() && x <= m_edges.back())) {
+        return std::nullopt;
+    }
+
+    std::size_t nbins = size();
+
+    if (m_width.has_value()) {
+        auto i = std::min(static_cast<std::size_t>((x - m_edges.front()) / m_width.value()), nbins - 1);
+
+        // Correct for rounding error in the division
+        if (x < m_edges[i]) {
+            i--;
+        } else if (i + 1 < nbins && x >= m_edges[i + 1]) {
+            i++;
+        }
+
+        return i;
+    }
+
+    auto it = std::upper_bound(m_edges.begin(), m_edges.end(), x);
+    auto i = static_cast<std::size_t>(std::distance(m_edges.begin(), it)) - 1;
+
+    return std::min(i, nbins - 1);
+}
+
+void
+BinnedHistogram::process(double x, double coverage, double weighted_coverage)
+{
+    auto i = bin(x);
+
+    if (i.has_value()) {
+        m_sum_ci[*i] += coverage;
+        m_sum_ciwi[*i] += weighted_coverage;
+    }
+}
+
+}
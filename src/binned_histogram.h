@@ -0,0 +1,80 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace exactextract {
+
+/**
+ * @brief The BinnedHistogram class accumulates the coverage (and weighted coverage)
+ *        of values falling into a fixed set of bins. Unlike the histogram of
+ *        distinct values maintained by `RasterStats`, its memory use depends only
+ *        on the number of bins, making it suitable for continuous rasters.
+ *
+ * Bins are defined by a sequence of increasing edges. Each bin includes its lower
+ * edge and excludes its upper edge, except for the last bin, which includes both.
+ * Values outside of the range of the edges are not counted.
+ */
+class BinnedHistogram
+{
+  public:
+    /// Construct a histogram with bins defined by the provided edges
+    explicit BinnedHistogram(std::vector<double> edges);
+
+    /// Construct a histogram with `bins` bins of equal width between `min` and `max`
+    static BinnedHistogram fixed_width(double min, double max, std::size_t bins);
+
+    void process(double x, double coverage, double weighted_coverage);
+
+    /// Returns the index of the bin containing `x`, if any
+    std::optional<std::size_t> bin(double x) const;
+
+    /// Returns the number of bins
+    std::size_t size() const
+    {
+        return m_sum_ci.size();
+    }
+
+    const std::vector<double>& edges() const
+    {
+        return m_edges;
+    }
+
+    /// Returns the sum of the coverage fractions of values in each bin
+    const std::vector<double>& counts() const
+    {
+        return m_sum_ci;
+    }
+
+    /// Returns the sum of the coverage fractions of values in each bin,
+    /// multiplied by their weights
+    const std::vector<double>& weighted_counts() const
+    {
+        return m_sum_ciwi;
+    }
+
+  private:
+    std::vector<double> m_edges;
+    std::vector<double> m_sum_ci;
+    std::vector<double> m_sum_ciwi;
+
+    // Set when all bins have the same width, so that the bin for a value
+    // can be computed without a search
+    std::optional<double> m_width;
+};
+
+}
@@ -0,0 +1,258 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "columnar_feature_source.h"
+
+#include <limits>
+#include <stdexcept>
+
+namespace exactextract {
+
+ColumnarFeatureSource::ColumnarFeatureSource(std::size_t count)
+  : m_count(count)
+  , m_next(0)
+  , m_feature(*this)
+{
+}
+
+void
+ColumnarFeatureSource::add_column(const std::string& name, Column values, std::vector<bool> missing)
+{
+    std::size_t size = std::visit([](const auto& v) { return v.size(); }, values);
+    if (size != m_count) {
+        throw std::runtime_error("Column " + name + " has " + std::to_string(size) + " values but " + std::to_string(m_count) + " features were expected.");
+    }
+    if (!missing.empty() && missing.size() != m_count) {
+        throw std::runtime_error("Column " + name + " has " + std::to_string(missing.size()) + " missing value flags but " + std::to_string(m_count) + " features were expected.");
+    }
+
+    if (!has_column(name)) {
+        m_column_names.push_back(name);
+    }
+    m_columns[name] = std::move(values);
+
+    if (missing.empty()) {
+        m_missing.erase(name);
+    } else {
+        m_missing[name] = std::move(missing);
+    }
+}
+
+void
+ColumnarFeatureSource::set_wkb(std::vector<std::string_view> wkb)
+{
+    if (wkb.size() != m_count) {
+        throw std::runtime_error("Number of geometries does not match number of features.");
+    }
+
+    m_wkb = std::move(wkb);
+}
+
+bool
+ColumnarFeatureSource::next()
+{
+    if (m_next >= m_count) {
+        // reset so that the source can be read again
+        m_next = 0;
+        return false;
+    }
+
+    m_feature.set_row(m_next++);
+    return true;
+}
+
+const ColumnarFeatureSource::Column&
+ColumnarFeatureSource::column(const std::string& name) const
+{
+    auto it = m_columns.find(name);
+    if (it == m_columns.end()) {
+        throw std::runtime_error("No field named " + name + ".");
+    }
+    return it->second;
+}
+
+void
+ColumnarFeatureSource::ColumnarFeature::set_row(std::size_t row)
+{
+    m_row = row;
+    m_geom.reset();
+    m_geom_read = false;
+}
+
+template<typename T>
+const T&
+ColumnarFeatureSource::ColumnarFeature::value(const std::string& name) const
+{
+    const auto* values = std::get_if<std::vector<T>>(&m_src.column(name));
+    if (values == nullptr) {
+        throw std::runtime_error("Field " + name + " is not of the requested type.");
+    }
+    return (*values)[m_row];
+}
+
+bool
+ColumnarFeatureSource::ColumnarFeature::is_missing(const std::string& name) const
+{
+    auto it = m_src.m_missing.find(name);
+    return it != m_src.m_missing.end() && it->second[m_row];
+}
+
+Feature::ValueType
+ColumnarFeatureSource::ColumnarFeature::field_type(const std::string& name) const
+{
+    const Column& col = m_src.column(name);
+
+    if (is_missing(name)) {
+        return ValueType::DOUBLE;
+    }
+
+    if (std::holds_alternative<std::vector<std::string>>(col)) {
+        return ValueType::STRING;
+    }
+    if (std::holds_alternative<std::vector<double>>(col)) {
+        return ValueType::DOUBLE;
+    }
+    if (std::holds_alternative<std::vector<std::int32_t>>(col)) {
+        return ValueType::INT;
+    }
+    return ValueType::INT64;
+}
+
+std::string
+ColumnarFeatureSource::ColumnarFeature::get_string(const std::string& name) const
+{
+    return value<std::string>(name);
+}
+
+double
+ColumnarFeatureSource::ColumnarFeature::get_double(const std::string& name) const
+{
+    if (is_missing(name)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return value<double>(name);
+}
+
+std::int32_t
+ColumnarFeatureSource::ColumnarFeature::get_int(const std::string& name) const
+{
+    return value<std::int32_t>(name);
+}
+
+std::int64_t
+ColumnarFeatureSource::ColumnarFeature::get_int64(const std::string& name) const
+{
+    return value<std::int64_t>(name);
+}
+
+Feature::DoubleArray
+ColumnarFeatureSource::ColumnarFeature::get_double_array(const std::string& name) const
+{
+    throw std::runtime_error("Field " + name + " is not an array.");
+}
+
+Feature::IntegerArray
+ColumnarFeatureSource::ColumnarFeature::get_integer_array(const std::string& name) const
+{
+    throw std::runtime_error("Field " + name + " is not an array.");
+}
+
+Feature::Integer64Array
+ColumnarFeatureSource::ColumnarFeature::get_integer64_array(const std::string& name) const
+{
+    throw std::runtime_error("Field " + name + " is not an array.");
+}
+
+static void
+read_only()
+{
+    throw std::runtime_error("Features from a ColumnarFeatureSource cannot be modified.");
+}
+
+void
+ColumnarFeatureSource::ColumnarFeature::set(const std::string&, std::string)
+{
+    read_only();
+}
+
+void
+ColumnarFeatureSource::ColumnarFeature::set(const std::string&, double)
+{
+    read_only();
+}
+
+void
+ColumnarFeatureSource::ColumnarFeature::set(const std::string&, std::int32_t)
+{
+    read_only();
+}
+
+void
+ColumnarFeatureSource::ColumnarFeature::set(const std::string&, std::int64_t)
+{
+    read_only();
+}
+
+void
+ColumnarFeatureSource::ColumnarFeature::set(const std::string&, const DoubleArray&)
+{
+    read_only();
+}
+
+void
+ColumnarFeatureSource::ColumnarFeature::set(const std::string&, const IntegerArray&)
+{
+    read_only();
+}
+
+void
+ColumnarFeatureSource::ColumnarFeature::set(const std::string&, const Integer64Array&)
+{
+    read_only();
+}
+
+void
+ColumnarFeatureSource::ColumnarFeature::set_geometry(const GEOSGeometry*)
+{
+    read_only();
+}
+
+void
+ColumnarFeatureSource::ColumnarFeature::copy_to(Feature& dst) const
+{
+    for (const auto& name : m_src.m_column_names) {
+        dst.set(name, *this);
+    }
+    dst.set_geometry(geometry());
+}
+
+const GEOSGeometry*
+ColumnarFeatureSource::ColumnarFeature::geometry() const
+{
+    if (!m_geom_read) {
+        if (m_row < m_src.m_wkb.size() && m_src.m_wkb[m_row].data() != nullptr) {
+            const auto& wkb = m_src.m_wkb[m_row];
+            m_geom = geos_ptr(m_context, GEOSGeomFromWKB_buf_r(m_context, reinterpret_cast<const unsigned char*>(wkb.data()), wkb.size()));
+
+            if (m_geom == nullptr) {
+                throw std::runtime_error("Failed to parse geometry.");
+            }
+        }
+
+        m_geom_read = true;
+    }
+
+    return m_geom.get();
+}
+
+}
@@ -0,0 +1,151 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "feature.h"
+#include "feature_source.h"
+#include "geos_utils.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace exactextract {
+
+/**
+ * @brief A FeatureSource whose attributes and geometries are provided in bulk as columns,
+ *        e.g. from a data frame.
+ *
+ * Geometries are provided as WKB buffers that are borrowed, not copied; the caller
+ * must keep them alive for the lifetime of the ColumnarFeatureSource. Each geometry
+ * is parsed only when the feature is read.
+ */
+class ColumnarFeatureSource : public FeatureSource
+{
+  public:
+    using Column = std::variant<std::vector<std::string>, std::vector<double>, std::vector<std::int32_t>, std::vector<std::int64_t>>;
+
+    explicit ColumnarFeatureSource(std::size_t count);
+
+    ColumnarFeatureSource(const ColumnarFeatureSource&) = delete;
+    ColumnarFeatureSource& operator=(const ColumnarFeatureSource&) = delete;
+
+    /// Add an attribute column, which must have one value per feature. Values for which
+    /// `missing` is true are read as a NaN double, regardless of the type of the column.
+    void add_column(const std::string& name, Column values, std::vector<bool> missing = {});
+
+    /// Set the WKB of each feature. A view with a null data pointer indicates a missing geometry.
+    void set_wkb(std::vector<std::string_view> wkb);
+
+    bool has_column(const std::string& name) const
+    {
+        return m_columns.find(name) != m_columns.end();
+    }
+
+    std::size_t count() const override
+    {
+        return m_count;
+    }
+
+    bool next() override;
+
+    void reset() override
+    {
+        m_next = 0;
+    }
+
+    const Feature& feature() const override
+    {
+        return m_feature;
+    }
+
+  private:
+    class ColumnarFeature : public Feature
+    {
+      public:
+        explicit ColumnarFeature(const ColumnarFeatureSource& src)
+          : m_src(src)
+          , m_row(0)
+        {
+        }
+
+        void set_row(std::size_t row);
+
+        ValueType field_type(const std::string& name) const override;
+
+        std::string get_string(const std::string& name) const override;
+
+        double get_double(const std::string& name) const override;
+
+        std::int32_t get_int(const std::string& name) const override;
+
+        std::int64_t get_int64(const std::string& name) const override;
+
+        DoubleArray get_double_array(const std::string& name) const override;
+
+        IntegerArray get_integer_array(const std::string& name) const override;
+
+        Integer64Array get_integer64_array(const std::string& name) const override;
+
+        using Feature::set;
+
+        void set(const std::string& name, std::string value) override;
+
+        void set(const std::string& name, double value) override;
+
+        void set(const std::string& name, std::int32_t value) override;
+
+        void set(const std::string& name, std::int64_t value) override;
+
+        void set(const std::string& name, const DoubleArray& value) override;
+
+        void set(const std::string& name, const IntegerArray& value) override;
+
+        void set(const std::string& name, const Integer64Array& value) override;
+
+        void copy_to(Feature& dst) const override;
+
+        const GEOSGeometry* geometry() const override;
+
+        void set_geometry(const GEOSGeometry*) override;
+
+      private:
+        template<typename T>
+        const T& value(const std::string& name) const;
+
+        bool is_missing(const std::string& name) const;
+
+        const ColumnarFeatureSource& m_src;
+        std::size_t m_row;
+        mutable geom_ptr_r m_geom;
+        mutable bool m_geom_read = false;
+    };
+
+    const Column& column(const std::string& name) const;
+
+    inline static thread_local GEOSContextHandle_t m_context = initGEOS_r(nullptr, nullptr);
+
+    std::size_t m_count;
+    std::size_t m_next;
+    std::vector<std::string> m_column_names;
+    std::unordered_map<std::string, Column> m_columns;
+    std::unordered_map<std::string, std::vector<bool>> m_missing;
+    std::vector<std::string_view> m_wkb;
+    ColumnarFeature m_feature;
+};
+
+}
@@ -11,7 +11,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cmath>
 #include <exception>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
@@ -24,6 +27,7 @@
 #include "feature_sequential_processor.h"
 #include "gdal_dataset_wrapper.h"
 #include "gdal_raster_wrapper.h"
+#include "gdal_reprojection.h"
 #include "gdal_writer.h"
 #include "operation.h"
 #include "processor.h"
@@ -46,22 +50,33 @@ load_dataset(const std::string& descriptor,
              const std::string& dst_id_type);
 
 static void
-check_crs_consistent(const GDALDatasetWrapper& features, const std::vector<std::unique_ptr<exactextract::RasterSource>>& rasters, const std::vector<std::unique_ptr<exactextract::RasterSource>>& weights);
+set_reprojections(const GDALDatasetWrapper& features, const std::vector<std::unique_ptr<exactextract::RasterSource>>& rasters, const std::vector<std::unique_ptr<exactextract::RasterSource>>& weights);
+
+/// OutputWriter that discards all features, used when no output will be written
+class NullWriter : public exactextract::OutputWriter
+{
+  public:
+    void write(const exactextract::Feature&) override {}
+};
 
 int
 main(int argc, char** argv)
 {
     CLI::App app{ "Zonal statistics using exactextract: version " + exactextract::version() };
 
-    std::string poly_descriptor, src_id_name, output_filename, strategy, dst_id_type, dst_id_name;
+    std::string poly_descriptor, src_id_name, output_filename, strategy, dst_id_type, dst_id_name, profile_json;
     std::vector<std::string> stats;
     std::vector<std::string> raster_descriptors;
     std::vector<std::string> weight_descriptors;
     std::vector<std::string> include_cols;
-    size_t max_cells_in_memory = 30;
+    double max_cells_in_memory = 30;
 
     bool progress = false;
+    bool explain = false;
+    bool profile = false;
     bool nested_output = false;
+    bool stream_cells = false;
+    bool omit_outside = false;
     bool include_geom = false;
     double grid_compat_tol = std::numeric_limits<double>::quiet_NaN();
 
@@ -69,18 +84,23 @@ main(int argc, char** argv)
     app.add_option("-r,--raster", raster_descriptors, "raster dataset")->required(true);
     app.add_option("-w,--weights", weight_descriptors, "weighting dataset")->required(false);
     app.add_option("-f,--fid", src_id_name, "id from polygon dataset to retain in output")->required(false);
-    app.add_option("-o,--output", output_filename, "output filename")->required(true);
+    app.add_option("-o,--output", output_filename, "output filename (required unless --explain is used)")->required(false);
     app.add_option("-s,--stat", stats, "statistics")->required(false)->expected(-1);
     app.add_option("--max-cells", max_cells_in_memory, "maximum number of raster cells to read in memory at once, in millions")->required(false)->default_val("30");
     app.add_option("--strategy", strategy, "processing strategy")->required(false)->default_val("feature-sequential");
     app.add_option("--id-type", dst_id_type, "override type of id field in output")->required(false);
     app.add_option("--id-name", dst_id_name, "override name of id field in output")->required(false);
     app.add_flag("--nested-output", nested_output, "nested output");
+    app.add_flag("--stream-cells", stream_cells, "write per-cell operations (values, coverage, etc.) in chunks as cells are processed");
+    app.add_flag("--omit-features-outside", omit_outside, "omit features that do not intersect the rasters from the output, instead of writing empty statistics");
     app.add_option("--include-col", include_cols, "columns from input to include in output");
     app.add_flag("--include-geom", include_geom, "include geometry in output");
     app.add_flag("--grid-compat-tol", grid_compat_tol, "grid compatibility tolerance");
 
     app.add_flag("--progress", progress);
+    app.add_flag("--explain", explain, "describe the processing plan and estimated reads without processing");
+    app.add_flag("--profile", profile, "report the time spent in each phase of processing");
+    app.add_option("--profile-json", profile_json, "write the time spent in each phase of processing to a JSON file")->required(false);
     app.set_config("--config");
 
     if (argc == 1) {
@@ -102,8 +122,14 @@ main(int argc, char** argv)
     if (src_id_name.empty() && !dst_id_name.empty()) {
         src_id_name = dst_id_name;
     }
-
-    max_cells_in_memory *= 1000000;
+    if (output_filename.empty() && !explain) {
+        std::cerr << "--output is required" << std::endl;
+        return 1;
+    }
+    if (stream_cells && nested_output) {
+        std::cerr << "--stream-cells cannot be used with --nested-output" << std::endl;
+        return 1;
+    }
 
     std::unique_ptr<exactextract::Processor> proc;
     std::unique_ptr<exactextract::OutputWriter> writer;
@@ -119,10 +145,7 @@ main(int argc, char** argv)
 
         GDALDatasetWrapper shp = load_dataset(poly_descriptor, include_cols, src_id_name, dst_id_name, dst_id_type);
 
-        check_crs_consistent(shp, rasters, weights);
-
-        std::unique_ptr<exactextract::GDALWriter> gdal_writer = std::make_unique<exactextract::GDALWriter>(
-          output_filename, !nested_output, shp.srs());
+        set_reprojections(shp, rasters, weights);
 
         if (!dst_id_name.empty()) {
             include_cols.insert(include_cols.begin(), dst_id_name);
@@ -130,11 +153,18 @@ main(int argc, char** argv)
             include_cols.insert(include_cols.begin(), src_id_name);
         }
 
-        for (const auto& field : include_cols) {
-            gdal_writer->copy_field(shp, field);
-        }
+        if (explain) {
+            writer = std::make_unique<NullWriter>();
+        } else {
+            std::unique_ptr<exactextract::GDALWriter> gdal_writer = std::make_unique<exactextract::GDALWriter>(
+              output_filename, !nested_output, shp.srs());
 
-        writer = std::move(gdal_writer);
+            for (const auto& field : include_cols) {
+                gdal_writer->copy_field(shp, field);
+            }
+
+            writer = std::move(gdal_writer);
+        }
 
         if (strategy == "feature-sequential") {
             proc = std::make_unique<exactextract::FeatureSequentialProcessor>(shp, *writer);
@@ -144,6 +174,9 @@ main(int argc, char** argv)
             throw std::runtime_error("Unknown processing strategy: " + strategy);
         }
 
+        proc->set_stream_cells(stream_cells);
+        proc->set_omit_features_outside(omit_outside);
+
         for (const auto& op : operations) {
             proc->add_operation(*op);
         }
@@ -160,15 +193,33 @@ main(int argc, char** argv)
             proc->set_grid_compat_tol(grid_compat_tol);
         }
 
-        proc->set_max_cells_in_memory(max_cells_in_memory);
+        proc->set_max_cells_in_memory(std::max(static_cast<size_t>(std::llround(max_cells_in_memory * 1e6)), static_cast<size_t>(1)));
+        proc->collect_profile(profile || !profile_json.empty());
         proc->show_progress(progress);
         if (progress) {
             proc->set_progress_fn(exactextract::cli_progress);
         }
 
+        if (explain) {
+            proc->explain(std::cout);
+            return 0;
+        }
+
         proc->process();
         writer->finish();
 
+        if (profile) {
+            proc->profile().write(std::cerr);
+        }
+
+        if (!profile_json.empty()) {
+            std::ofstream json(profile_json);
+            if (!json) {
+                throw std::runtime_error("Failed to open " + profile_json + " for writing.");
+            }
+            proc->profile().write_json(json);
+        }
+
         return 0;
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -224,20 +275,41 @@ load_dataset(const std::string& descriptor,
     return ds;
 }
 
+/// Sets a Reprojection from the CRS of the features on each raster with a different CRS.
+/// Rasters with the same CRS share a Reprojection, so that each feature is reprojected
+/// only once for them.
 static void
-check_crs_consistent(const GDALDatasetWrapper& features, const std::vector<std::unique_ptr<exactextract::RasterSource>>& rasters, const std::vector<std::unique_ptr<exactextract::RasterSource>>& weights)
+set_reprojections(const GDALDatasetWrapper& features, const std::vector<std::unique_ptr<exactextract::RasterSource>>& rasters, const std::vector<std::unique_ptr<exactextract::RasterSource>>& weights)
 {
-    OGRSpatialReferenceH expected = features.srs();
-    for (const auto& raster : rasters) {
-        OGRSpatialReferenceH srs = static_cast<const GDALRasterWrapper*>(raster.get())->srs();
-        if (!OSRIsSame(srs, expected)) {
-            std::cerr << "Input features do not have the same CRS as raster " << raster->name() << std::endl;
-        }
-    }
-    for (const auto& raster : weights) {
-        OGRSpatialReferenceH srs = static_cast<const GDALRasterWrapper*>(raster.get())->srs();
-        if (!OSRIsSame(srs, expected)) {
-            std::cerr << "Input features do not have the same CRS as raster " << raster->name() << std::endl;
+    OGRSpatialReferenceH feature_srs = features.srs();
+
+    std::vector<std::pair<OGRSpatialReferenceH, std::shared_ptr<const exactextract::Reprojection>>> reprojections;
+
+    for (const auto* sources : { &rasters, &weights }) {
+        for (const auto& raster : *sources) {
+            OGRSpatialReferenceH srs = static_cast<const GDALRasterWrapper*>(raster.get())->srs();
+
+            if (srs == nullptr || feature_srs == nullptr) {
+                if (srs != feature_srs) {
+                    std::cerr << "Input features and raster " << raster->name() << " may not have the same CRS; features will not be reprojected." << std::endl;
+                }
+                continue;
+            }
+
+            if (OSRIsSame(srs, feature_srs)) {
+                continue;
+            }
+
+            auto it = std::find_if(reprojections.begin(), reprojections.end(), [srs](const auto& r) {
+                return OSRIsSame(r.first, srs);
+            });
+
+            if (it == reprojections.end()) {
+                reprojections.emplace_back(srs, std::make_shared<exactextract::GDALReprojection>(feature_srs, srs));
+                it = std::prev(reprojections.end());
+            }
+
+            raster->set_reprojection(it->second);
         }
     }
 }
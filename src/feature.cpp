@@ -12,6 +12,7 @@
 // limitations under the License.
 
 #include "feature.h"
+#include "geos_utils.h"
 
 #include <cmath>
 #include <limits>
@@ -19,6 +20,20 @@
 #include <vector>
 
 namespace exactextract {
+
+std::optional<Box>
+Feature::envelope() const
+{
+    static thread_local GEOSContextHandle_t context = initGEOS_r(nullptr, nullptr);
+
+    const GEOSGeometry* g = geometry();
+    if (g == nullptr || GEOSisEmpty_r(context, g)) {
+        return std::nullopt;
+    }
+
+    return geos_get_box(context, g);
+}
+
 void
 Feature::set(const std::string& name, const Feature& f)
 {
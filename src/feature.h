@@ -15,12 +15,15 @@
 
 #include <cstdint>
 #include <cstring>
+#include <optional>
 #include <string>
 #include <variant>
 #include <vector>
 
 #include <geos_c.h>
 
+#include "box.h"
+
 namespace exactextract {
 class Feature
 {
@@ -200,6 +203,10 @@ class Feature
     virtual void set_geometry(const GEOSGeometry*) = 0;
 
     // Convenience methods (can be overridden)
+    /// Return the bounding box of the geometry, or `std::nullopt` if the feature has no
+    /// geometry. Overridden by features that can compute it without a GEOS geometry.
+    virtual std::optional<Box> envelope() const;
+
     virtual void set(const std::string& name, float value);
 
     virtual void set(const std::string& name, const FloatArray& value);
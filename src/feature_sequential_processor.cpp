@@ -11,7 +11,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <set>
+#include <optional>
 #include <sstream>
 #include <string>
 
@@ -20,7 +20,6 @@
 #include "geos_utils.h"
 #include "grid.h"
 #include "operation.h"
-#include "raster_cell_intersection.h"
 
 namespace exactextract {
 
@@ -58,69 +57,141 @@ FeatureSequentialProcessor::progress_message(const Feature& f)
 void
 FeatureSequentialProcessor::process()
 {
+    auto timer = m_profile.time(ProcessingProfile::Phase::TOTAL);
+    begin_progress();
+
+    std::vector<ProcessingPlan> plans = make_plans();
+    std::optional<Box> extent = apply_spatial_filter(plans);
+
     std::size_t n = m_shp.count();
-    for (std::size_t i = 0; m_shp.next(); i++) {
+    for (std::size_t i = 0; next_feature(); i++) {
         const Feature& f_in = m_shp.feature();
 
-        auto geom = f_in.geometry();
-
         if (m_show_progress) {
             double frac = static_cast<double>(i + 1) / n;
             progress(frac, progress_message(f_in));
         }
 
-        Box feature_bbox = exactextract::geos_get_box(m_geos_context, geom);
+        // Features outside of all grids are identified from their envelopes, without
+        // constructing their GEOS geometries.
+        if (outside(f_in, extent)) {
+            m_profile.add_feature(true);
+            if (!m_omit_features_outside) {
+                write_result(f_in);
+            }
+            continue;
+        }
+
+        // Coverage is computed from the geometry in the coordinates of each grid,
+        // which differ from those of the feature if the rasters are rotated or
+        // in a different coordinate reference system.
+        std::vector<geom_ptr_r> transformed;
+        auto grid_geoms = to_grid_coords(plans, f_in.geometry(), transformed);
+
+        bool intersects_any = false;
+
+        for (std::size_t p = 0; p < plans.size(); p++) {
+            const ProcessingPlan& plan = plans[p];
+            const auto& grid = plan.grid();
+            const GEOSGeometry* geom = grid_geoms[p];
 
-        auto grid = common_grid(m_operations.begin(), m_operations.end(), m_grid_compat_tol);
+            Box feature_bbox = exactextract::geos_get_box(m_geos_context, geom);
+
+            if (!feature_bbox.intersects(grid.extent())) {
+                continue;
+            }
+            intersects_any = true;
 
-        if (feature_bbox.intersects(grid.extent())) {
             // Crop grid to portion overlapping feature
             auto cropped_grid = grid.crop(feature_bbox);
 
-            for (const auto& subgrid : subdivide(cropped_grid, m_max_cells_in_memory)) {
-                std::unique_ptr<Raster<float>> coverage;
+            auto subgrids = subdivide_aligned(plan, cropped_grid);
+            auto divided = divided_rasters(plan, cropped_grid, subgrids);
 
-                std::set<std::string> processed;
+            for (const auto& subgrid : subgrids) {
+                std::unique_ptr<Raster<float>> coverage;
 
                 std::map<RasterSource*, RasterVariant> values_map;
                 std::map<RasterSource*, RasterVariant> weights_map;
+                std::map<RasterSource*, std::unique_ptr<Raster<float>>> aggregated_coverage;
 
-                for (const auto& op : m_operations) {
-                    // Avoid processing same values/weights for different stats
-                    if (processed.find(op->key()) != processed.end()) {
-                        continue;
-                    } else {
-                        processed.insert(op->key());
-                    }
-
+                for (const Operation* op : plan.stats_operations()) {
                     if (!op->intersects(subgrid.extent())) {
                         continue;
                     }
 
                     // Lazy-initialize coverage
                     if (coverage == nullptr) {
-                        coverage = std::make_unique<Raster<float>>(
-                          raster_cell_intersection(subgrid, m_geos_context, geom));
+                        coverage = std::make_unique<Raster<float>>(compute_coverage(subgrid, geom));
                     }
 
                     if (values_map.find(op->values) == values_map.end()) {
-                        values_map[op->values] = op->values->read_box(subgrid.extent().intersection(op->values->grid().extent()));
+                        values_map[op->values] = read_box(*op->values, subgrid.extent().intersection(op->values->grid().extent()));
                     }
 
                     if (op->weighted()) {
                         if (weights_map.find(op->weights) == weights_map.end()) {
-                            weights_map[op->weights] = op->weights->read_box(subgrid.extent().intersection(op->weights->grid().extent()));
+                            weights_map[op->weights] = read_box(*op->weights, subgrid.extent().intersection(op->weights->grid().extent()));
                         }
 
+                        auto stats_timer = m_profile.time(ProcessingProfile::Phase::STATS);
                         m_reg.update_stats(f_in, *op, *coverage, values_map[op->values], weights_map[op->weights]);
                     } else {
-                        m_reg.update_stats(f_in, *op, *coverage, values_map[op->values]);
+                        auto stats_timer = m_profile.time(ProcessingProfile::Phase::STATS);
+                        m_reg.update_stats(f_in, *op, coverage_for(*op, *coverage, geom, divided, aggregated_coverage), values_map[op->values]);
                     }
                 }
+
+                write_stored_cells(f_in);
             }
         }
 
-        write_result(f_in);
+        m_profile.add_feature(!intersects_any);
+
+        if (intersects_any || !m_omit_features_outside) {
+            write_result(f_in);
+        }
+    }
+
+    write_pending_features();
+}
+
+void
+FeatureSequentialProcessor::explain(std::ostream& os)
+{
+    std::vector<ProcessingPlan> plans = make_plans();
+    std::optional<Box> extent = apply_spatial_filter(plans);
+
+    std::size_t n = 0;
+    while (m_shp.next()) {
+        n++;
+
+        if (outside(m_shp.feature(), extent)) {
+            continue;
+        }
+
+        std::vector<geom_ptr_r> transformed;
+        auto grid_geoms = to_grid_coords(plans, m_shp.feature().geometry(), transformed);
+
+        for (std::size_t p = 0; p < plans.size(); p++) {
+            ProcessingPlan& plan = plans[p];
+            Box feature_bbox = exactextract::geos_get_box(m_geos_context, grid_geoms[p]);
+
+            if (feature_bbox.intersects(plan.grid().extent())) {
+                for (const auto& subgrid : subdivide_aligned(plan, plan.grid().crop(feature_bbox))) {
+                    plan.schedule_read(subgrid.extent());
+                }
+            }
+        }
+    }
+
+    // Rewind the features so that they can be read again by `process`
+    m_shp.reset();
+
+    os << "Strategy: feature-sequential" << std::endl;
+    os << "Features: " << n << std::endl;
+    for (const auto& plan : plans) {
+        plan.explain(os);
     }
 }
 }
@@ -29,6 +29,8 @@ class FeatureSequentialProcessor : public Processor
 
     void process() override;
 
+    void explain(std::ostream& os) override;
+
   private:
     std::string progress_message(const Feature& f);
 };
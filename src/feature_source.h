@@ -15,6 +15,8 @@
 
 #include <cstddef>
 
+#include "box.h"
+
 namespace exactextract {
 
 class Feature;
@@ -29,6 +31,20 @@ class FeatureSource
     virtual bool next() = 0;
 
     virtual std::size_t count() const = 0;
+
+    /// Rewind the source, so that the next call to `next` reads the first feature.
+    virtual void reset() = 0;
+
+    /**
+     * @brief Indicate that only features whose bounding boxes intersect `box` are
+     *        needed, so that a source with a spatial index may skip the others.
+     *        Sources are not required to skip any features. Must be called before
+     *        features are read.
+     */
+    virtual void set_spatial_filter(const Box& box)
+    {
+        (void)box;
+    }
 };
 
 }
@@ -0,0 +1,271 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace exactextract {
+
+/**
+ * @brief The FrequencyTable class associates an `Entry` with each distinct value
+ *        that has been added to it.
+ *
+ * Integral values are stored in a dense array spanning the range of values
+ * observed, so that updating the entry for a value is an array access rather
+ * than a hash lookup. For 8-bit types the array covers all possible values; for
+ * wider types it grows as values are added, up to `MAX_DENSE_SIZE` entries.
+ * Values that cannot be accommodated in the array, and all floating-point values,
+ * are stored in a hash map.
+ *
+ * Iteration visits values in the dense array in ascending order, followed by
+ * values in the hash map in no particular order.
+ */
+template<typename T, typename Entry>
+class FrequencyTable
+{
+  public:
+    static constexpr std::size_t MAX_DENSE_SIZE = 65536;
+
+    /// Return the entry for a value, creating it if necessary
+    Entry& operator[](const T& value)
+    {
+        if constexpr (std::is_integral_v<T>) {
+            if (in_dense_range(value) || grow_dense(value)) {
+                std::size_t i = dense_index(value);
+
+                m_dense_count += static_cast<std::size_t>(m_dense_present[i] == 0);
+                m_dense_present[i] = 1;
+
+                return m_dense[i];
+            }
+        }
+
+        return m_sparse[value];
+    }
+
+    /// Return the entry for a value, or `nullptr` if the value has not been added
+    const Entry* find(const T& value) const
+    {
+        if constexpr (std::is_integral_v<T>) {
+            if (in_dense_range(value)) {
+                std::size_t i = dense_index(value);
+                return m_dense_present[i] ? &m_dense[i] : nullptr;
+            }
+        }
+
+        auto it = m_sparse.find(value);
+        if (it == m_sparse.end()) {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    /// Return the number of distinct values that have been added
+    std::size_t size() const
+    {
+        return m_dense_count + m_sparse.size();
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    class Iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = std::pair<T, Entry>;
+        using pointer = const value_type*;
+        using reference = value_type;
+
+        Iterator(const FrequencyTable* table, std::size_t dense_pos, typename std::unordered_map<T, Entry>::const_iterator sparse_it)
+          : m_table(table)
+          , m_dense_pos(dense_pos)
+          , m_sparse_it(sparse_it)
+        {
+            skip_absent();
+        }
+
+        value_type operator*() const
+        {
+            if (m_dense_pos < m_table->m_dense.size()) {
+                return { m_table->dense_value(m_dense_pos), m_table->m_dense[m_dense_pos] };
+            }
+            return *m_sparse_it;
+        }
+
+        // prefix
+        Iterator& operator++()
+        {
+            if (m_dense_pos < m_table->m_dense.size()) {
+                m_dense_pos++;
+                skip_absent();
+            } else {
+                ++m_sparse_it;
+            }
+            return *this;
+        }
+
+        // postfix
+        Iterator operator++(int)
+        {
+            Iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b)
+        {
+            return a.m_dense_pos == b.m_dense_pos && a.m_sparse_it == b.m_sparse_it;
+        }
+
+        friend bool operator!=(const Iterator& a, const Iterator& b)
+        {
+            return !(a == b);
+        }
+
+      private:
+        void skip_absent()
+        {
+            while (m_dense_pos < m_table->m_dense.size() && !m_table->m_dense_present[m_dense_pos]) {
+                m_dense_pos++;
+            }
+        }
+
+        const FrequencyTable* m_table;
+        std::size_t m_dense_pos;
+        typename std::unordered_map<T, Entry>::const_iterator m_sparse_it;
+    };
+
+    Iterator begin() const
+    {
+        return Iterator(this, 0, m_sparse.cbegin());
+    }
+
+    Iterator end() const
+    {
+        return Iterator(this, m_dense.size(), m_sparse.cend());
+    }
+
+  private:
+    // Values are mapped onto an unsigned "key" that preserves their order, so that
+    // the dense range can be managed without concern for signed overflow.
+    using Key = std::make_unsigned_t<std::conditional_t<std::is_integral_v<T>, T, int>>;
+
+    static Key key(const T& value)
+    {
+        return static_cast<Key>(static_cast<Key>(value) - static_cast<Key>(std::numeric_limits<T>::lowest()));
+    }
+
+    T dense_value(std::size_t i) const
+    {
+        return static_cast<T>(static_cast<Key>(m_dense_min + i) + static_cast<Key>(std::numeric_limits<T>::lowest()));
+    }
+
+    bool in_dense_range(const T& value) const
+    {
+        Key k = key(value);
+        return k >= m_dense_min && static_cast<std::size_t>(k - m_dense_min) < m_dense.size();
+    }
+
+    std::size_t dense_index(const T& value) const
+    {
+        return static_cast<std::size_t>(key(value) - m_dense_min);
+    }
+
+    bool grow_dense(const T& value)
+    {
+        // Arithmetic on keys is performed using std::uintmax_t to avoid integer promotion
+        constexpr std::uintmax_t max_key = std::numeric_limits<Key>::max();
+        std::uintmax_t k = key(value);
+        std::uintmax_t old_min = m_dense_min;
+
+        std::uintmax_t new_min;
+        std::size_t new_size;
+
+        if (m_dense.empty()) {
+            if constexpr (sizeof(T) == 1) {
+                new_min = 0;
+                new_size = static_cast<std::size_t>(max_key) + 1;
+            } else {
+                new_min = k;
+                new_size = 1;
+            }
+        } else {
+            std::uintmax_t lo = std::min(old_min, k);
+            std::uintmax_t hi = std::max(old_min + (m_dense.size() - 1), k);
+
+            if (hi - lo >= MAX_DENSE_SIZE) {
+                return false;
+            }
+
+            // Grow by at least a factor of two to limit the number of reallocations
+            new_size = std::max(static_cast<std::size_t>(hi - lo) + 1, std::min(2 * m_dense.size(), MAX_DENSE_SIZE));
+
+            if (k < old_min) {
+                new_min = hi >= new_size - 1 ? hi - (new_size - 1) : 0;
+            } else if (max_key - lo < new_size - 1) {
+                new_min = max_key - (new_size - 1);
+            } else {
+                new_min = lo;
+            }
+        }
+
+        std::vector<Entry> dense(new_size);
+        std::vector<std::uint8_t> present(new_size);
+
+        std::size_t shift = static_cast<std::size_t>(old_min - new_min);
+        for (std::size_t i = 0; i < m_dense.size(); i++) {
+            dense[i + shift] = m_dense[i];
+            present[i + shift] = m_dense_present[i];
+        }
+
+        m_dense = std::move(dense);
+        m_dense_present = std::move(present);
+        m_dense_min = static_cast<Key>(new_min);
+
+        // Move any values that now fall within the dense range out of the hash map
+        for (auto it = m_sparse.begin(); it != m_sparse.end();) {
+            if (in_dense_range(it->first)) {
+                std::size_t i = dense_index(it->first);
+                m_dense[i] = it->second;
+                m_dense_present[i] = 1;
+                m_dense_count++;
+                it = m_sparse.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        return true;
+    }
+
+    std::vector<Entry> m_dense;
+    std::vector<std::uint8_t> m_dense_present;
+    Key m_dense_min = 0;
+    std::size_t m_dense_count = 0;
+
+    std::unordered_map<T, Entry> m_sparse;
+};
+
+}
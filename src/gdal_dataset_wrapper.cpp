@@ -107,6 +107,12 @@ GDALDatasetWrapper::next()
     return raw_feature != nullptr;
 }
 
+void
+GDALDatasetWrapper::reset()
+{
+    OGR_L_ResetReading(m_layer);
+}
+
 void
 GDALDatasetWrapper::copy_field(const std::string& name, OGRLayerH copy_to) const
 {
@@ -136,6 +142,13 @@ GDALDatasetWrapper::srs() const
     return OGR_L_GetSpatialRef(m_layer);
 }
 
+void
+GDALDatasetWrapper::set_spatial_filter(const Box& box)
+{
+    OGR_L_SetSpatialFilterRect(m_layer, box.xmin, box.ymin, box.xmax, box.ymax);
+    OGR_L_ResetReading(m_layer);
+}
+
 std::size_t
 GDALDatasetWrapper::count() const
 {
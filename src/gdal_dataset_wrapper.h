@@ -36,6 +36,8 @@ class GDALDatasetWrapper : public FeatureSource
 
     bool next() override;
 
+    void reset() override;
+
     void copy_field(const std::string& field_name, OGRLayerH to) const;
 
     void set_select(const std::vector<std::string>& cols);
@@ -46,6 +48,8 @@ class GDALDatasetWrapper : public FeatureSource
 
     std::size_t count() const override;
 
+    void set_spatial_filter(const Box& box) override;
+
   private:
     GDALDatasetH m_dataset;
     OGRLayerH m_layer;
@@ -14,6 +14,7 @@
 #pragma once
 
 #include "feature.h"
+#include "gdal_geometry.h"
 #include "geos_utils.h"
 
 #include "ogr_api.h"
@@ -184,17 +185,27 @@ class GDALFeature : public Feature
             OGRGeometryH geom = OGR_F_GetGeometryRef(m_feature);
 
             if (geom != nullptr) {
-                auto sz = static_cast<size_t>(OGR_G_WkbSize(geom));
-                auto buff = std::make_unique<unsigned char[]>(sz);
-                OGR_G_ExportToWkb(geom, wkbXDR, buff.get());
-
-                m_geom = geos_ptr(m_context, GEOSGeomFromWKB_buf_r(m_context, buff.get(), sz));
+                m_geom = ogr_to_geos(m_context, geom);
             }
         }
 
         return m_geom.get();
     }
 
+    std::optional<Box> envelope() const override
+    {
+        OGRGeometryH geom = OGR_F_GetGeometryRef(m_feature);
+
+        if (geom == nullptr || OGR_G_IsEmpty(geom)) {
+            return std::nullopt;
+        }
+
+        OGREnvelope env;
+        OGR_G_GetEnvelope(geom, &env);
+
+        return Box(env.MinX, env.MinY, env.MaxX, env.MaxY);
+    }
+
     void set_geometry(const GEOSGeometry* geom) override
     {
         if (geom == nullptr) {
@@ -203,11 +214,7 @@ class GDALFeature : public Feature
         } else {
             m_geom = geos_ptr(m_context, GEOSGeom_clone_r(m_context, geom));
 
-            std::size_t wkbSize;
-            unsigned char* wkb = GEOSGeomToWKB_buf_r(m_context, m_geom.get(), &wkbSize);
-            OGRGeometryH ogr_geom;
-            OGR_G_CreateFromWkb(wkb, nullptr, &ogr_geom, -1);
-            OGR_F_SetGeometryDirectly(m_feature, ogr_geom);
+            OGR_F_SetGeometryDirectly(m_feature, geos_to_ogr(m_context, m_geom.get()));
         }
     }
 
@@ -228,7 +235,7 @@ class GDALFeature : public Feature
 
     OGRFeatureH m_feature;
     mutable geom_ptr_r m_geom;
-    static inline GEOSContextHandle_t m_context = initGEOS_r(nullptr, nullptr);
+    static inline thread_local GEOSContextHandle_t m_context = initGEOS_r(nullptr, nullptr);
 };
 
 }
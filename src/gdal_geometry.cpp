@@ -0,0 +1,290 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gdal_geometry.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <gdal.h>
+
+#define HAVE_GDAL_210 (GDAL_VERSION_MAJOR > 2 || (GDAL_VERSION_MAJOR == 2 && GDAL_VERSION_MINOR >= 1))
+
+namespace exactextract {
+
+static OGRwkbByteOrder
+native_byte_order()
+{
+    const std::uint16_t x = 1;
+    return *reinterpret_cast<const unsigned char*>(&x) == 1 ? wkbNDR : wkbXDR;
+}
+
+static geom_ptr_r
+check_geos(GEOSContextHandle_t context, GEOSGeometry* g)
+{
+    if (g == nullptr) {
+        throw std::runtime_error("Failed to convert geometry from OGR to GEOS.");
+    }
+    return geos_ptr(context, g);
+}
+
+static seq_ptr_r
+ogr_coord_seq(GEOSContextHandle_t context, OGRGeometryH geom, bool has_z, std::vector<double>& buf)
+{
+    auto n = static_cast<unsigned int>(OGR_G_GetPointCount(geom));
+    int stride = has_z ? 3 : 2;
+
+#if HAVE_3100
+    buf.resize(std::max(static_cast<std::size_t>(n) * static_cast<std::size_t>(stride), static_cast<std::size_t>(1)));
+
+    if (n > 0) {
+        OGR_G_GetPoints(geom,
+                        buf.data(),
+                        stride * static_cast<int>(sizeof(double)),
+                        buf.data() + 1,
+                        stride * static_cast<int>(sizeof(double)),
+                        has_z ? buf.data() + 2 : nullptr,
+                        stride * static_cast<int>(sizeof(double)));
+    }
+
+    auto seq = geos_ptr(context, GEOSCoordSeq_copyFromBuffer_r(context, buf.data(), n, has_z, false));
+#else
+    (void)buf;
+
+    auto seq = GEOSCoordSeq_create_ptr(context, n, static_cast<unsigned int>(stride));
+
+    for (unsigned int i = 0; i < n; i++) {
+        double x, y, z;
+        OGR_G_GetPoint(geom, static_cast<int>(i), &x, &y, &z);
+
+        GEOSCoordSeq_setX_r(context, seq.get(), i, x);
+        GEOSCoordSeq_setY_r(context, seq.get(), i, y);
+        if (has_z) {
+            GEOSCoordSeq_setZ_r(context, seq.get(), i, z);
+        }
+    }
+#endif
+
+    if (seq == nullptr) {
+        throw std::runtime_error("Failed to create coordinate sequence.");
+    }
+
+    return seq;
+}
+
+static geom_ptr_r
+ogr_to_geos(GEOSContextHandle_t context, OGRGeometryH geom, bool has_z, std::vector<double>& buf)
+{
+    OGRwkbGeometryType ogr_type = OGR_GT_Flatten(OGR_G_GetGeometryType(geom));
+
+    switch (ogr_type) {
+        case wkbPoint:
+            if (OGR_G_IsEmpty(geom)) {
+                return check_geos(context, GEOSGeom_createEmptyPoint_r(context));
+            }
+            return check_geos(context, GEOSGeom_createPoint_r(context, ogr_coord_seq(context, geom, has_z, buf).release()));
+        case wkbLineString:
+        case wkbLinearRing:
+            return check_geos(context, GEOSGeom_createLineString_r(context, ogr_coord_seq(context, geom, has_z, buf).release()));
+        case wkbPolygon: {
+            int nrings = OGR_G_GetGeometryCount(geom);
+            if (nrings == 0) {
+                return check_geos(context, GEOSGeom_createEmptyPolygon_r(context));
+            }
+
+            auto shell = check_geos(context, GEOSGeom_createLinearRing_r(context, ogr_coord_seq(context, OGR_G_GetGeometryRef(geom, 0), has_z, buf).release()));
+
+            std::vector<geom_ptr_r> holes;
+            for (int i = 1; i < nrings; i++) {
+                holes.push_back(check_geos(context, GEOSGeom_createLinearRing_r(context, ogr_coord_seq(context, OGR_G_GetGeometryRef(geom, i), has_z, buf).release())));
+            }
+
+            std::vector<GEOSGeometry*> hole_ptrs;
+            for (auto& hole : holes) {
+                hole_ptrs.push_back(hole.release());
+            }
+
+            return check_geos(context, GEOSGeom_createPolygon_r(context, shell.release(), hole_ptrs.data(), static_cast<unsigned int>(hole_ptrs.size())));
+        }
+        case wkbMultiPoint:
+        case wkbMultiLineString:
+        case wkbMultiPolygon:
+        case wkbGeometryCollection: {
+            int type = ogr_type == wkbMultiPoint        ? GEOS_MULTIPOINT
+                       : ogr_type == wkbMultiLineString ? GEOS_MULTILINESTRING
+                       : ogr_type == wkbMultiPolygon    ? GEOS_MULTIPOLYGON
+                                                        : GEOS_GEOMETRYCOLLECTION;
+
+            int ngeoms = OGR_G_GetGeometryCount(geom);
+
+            std::vector<geom_ptr_r> components;
+            for (int i = 0; i < ngeoms; i++) {
+                components.push_back(ogr_to_geos(context, OGR_G_GetGeometryRef(geom, i), has_z, buf));
+            }
+
+            std::vector<GEOSGeometry*> component_ptrs;
+            for (auto& component : components) {
+                component_ptrs.push_back(component.release());
+            }
+
+            return check_geos(context, GEOSGeom_createCollection_r(context, type, component_ptrs.data(), static_cast<unsigned int>(component_ptrs.size())));
+        }
+        default:
+            return ogr_to_geos_wkb(context, geom);
+    }
+}
+
+geom_ptr_r
+ogr_to_geos(GEOSContextHandle_t context, OGRGeometryH geom)
+{
+#if HAVE_GDAL_210
+    if (OGR_G_IsMeasured(geom)) {
+        return ogr_to_geos_wkb(context, geom);
+    }
+    bool has_z = OGR_G_Is3D(geom);
+#else
+    bool has_z = OGR_G_GetCoordinateDimension(geom) == 3;
+#endif
+
+    std::vector<double> buf;
+    return ogr_to_geos(context, geom, has_z, buf);
+}
+
+geom_ptr_r
+ogr_to_geos_wkb(GEOSContextHandle_t context, OGRGeometryH geom)
+{
+    auto sz = static_cast<size_t>(OGR_G_WkbSize(geom));
+    auto buff = std::make_unique<unsigned char[]>(sz);
+    OGR_G_ExportToWkb(geom, native_byte_order(), buff.get());
+
+    return check_geos(context, GEOSGeomFromWKB_buf_r(context, buff.get(), sz));
+}
+
+// Only X and Y are copied, consistent with the default output dimension of the GEOS WKB writer.
+static void
+set_ogr_points(GEOSContextHandle_t context, OGRGeometryH dst, const GEOSGeometry* src, std::vector<double>& buf)
+{
+    const GEOSCoordSequence* seq = GEOSGeom_getCoordSeq_r(context, src);
+    unsigned int n = geos_get_num_points(context, seq);
+
+    if (n == 0) {
+        return;
+    }
+
+    buf.resize(2 * static_cast<std::size_t>(n));
+    double* x = buf.data();
+    double* y = buf.data() + n;
+
+#if HAVE_3100
+    GEOSCoordSeq_copyToArrays_r(context, seq, x, y, nullptr, nullptr);
+#else
+    for (unsigned int i = 0; i < n; i++) {
+        GEOSCoordSeq_getX_r(context, seq, i, &x[i]);
+        GEOSCoordSeq_getY_r(context, seq, i, &y[i]);
+    }
+#endif
+
+    OGR_G_SetPoints(dst, static_cast<int>(n), x, static_cast<int>(sizeof(double)), y, static_cast<int>(sizeof(double)), nullptr, 0);
+}
+
+static OGRGeometryH
+geos_to_ogr(GEOSContextHandle_t context, const GEOSGeometry* geom, std::vector<double>& buf)
+{
+    OGRwkbGeometryType type;
+
+    switch (GEOSGeomTypeId_r(context, geom)) {
+        case GEOS_POINT:
+        case GEOS_LINESTRING:
+        case GEOS_LINEARRING: {
+            OGRGeometryH ret = OGR_G_CreateGeometry(GEOSGeomTypeId_r(context, geom) == GEOS_POINT ? wkbPoint : wkbLineString);
+            set_ogr_points(context, ret, geom, buf);
+            return ret;
+        }
+        case GEOS_POLYGON: {
+            OGRGeometryH ret = OGR_G_CreateGeometry(wkbPolygon);
+            if (GEOSisEmpty_r(context, geom)) {
+                return ret;
+            }
+
+            OGRGeometryH shell = OGR_G_CreateGeometry(wkbLinearRing);
+            set_ogr_points(context, shell, GEOSGetExteriorRing_r(context, geom), buf);
+            OGR_G_AddGeometryDirectly(ret, shell);
+
+            int nholes = GEOSGetNumInteriorRings_r(context, geom);
+            for (int i = 0; i < nholes; i++) {
+                OGRGeometryH hole = OGR_G_CreateGeometry(wkbLinearRing);
+                set_ogr_points(context, hole, GEOSGetInteriorRingN_r(context, geom, i), buf);
+                OGR_G_AddGeometryDirectly(ret, hole);
+            }
+
+            return ret;
+        }
+        case GEOS_MULTIPOINT:
+            type = wkbMultiPoint;
+            break;
+        case GEOS_MULTILINESTRING:
+            type = wkbMultiLineString;
+            break;
+        case GEOS_MULTIPOLYGON:
+            type = wkbMultiPolygon;
+            break;
+        case GEOS_GEOMETRYCOLLECTION:
+            type = wkbGeometryCollection;
+            break;
+        default:
+            return geos_to_ogr_wkb(context, geom);
+    }
+
+    // Destroy the partially built collection if converting a component throws
+    std::unique_ptr<std::remove_pointer_t<OGRGeometryH>, decltype(&OGR_G_DestroyGeometry)> ret(OGR_G_CreateGeometry(type), OGR_G_DestroyGeometry);
+
+    int ngeoms = GEOSGetNumGeometries_r(context, geom);
+    for (int i = 0; i < ngeoms; i++) {
+        OGR_G_AddGeometryDirectly(ret.get(), geos_to_ogr(context, GEOSGetGeometryN_r(context, geom, i), buf));
+    }
+
+    return ret.release();
+}
+
+OGRGeometryH
+geos_to_ogr(GEOSContextHandle_t context, const GEOSGeometry* geom)
+{
+    std::vector<double> buf;
+    return geos_to_ogr(context, geom, buf);
+}
+
+OGRGeometryH
+geos_to_ogr_wkb(GEOSContextHandle_t context, const GEOSGeometry* geom)
+{
+    std::size_t wkb_size;
+    unsigned char* wkb = GEOSGeomToWKB_buf_r(context, geom, &wkb_size);
+    if (wkb == nullptr) {
+        throw std::runtime_error("Failed to convert geometry from GEOS to OGR.");
+    }
+
+    OGRGeometryH ret = nullptr;
+    OGRErr err = OGR_G_CreateFromWkb(wkb, nullptr, &ret, static_cast<int>(wkb_size));
+    GEOSFree_r(context, wkb);
+
+    if (err != OGRERR_NONE) {
+        throw std::runtime_error("Failed to convert geometry from GEOS to OGR.");
+    }
+
+    return ret;
+}
+
+}
@@ -0,0 +1,53 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "geos_utils.h"
+
+#include <ogr_api.h>
+
+namespace exactextract {
+
+/**
+ * @brief Convert an OGR geometry to a GEOS geometry.
+ *
+ * Points, linestrings, polygons and their collections are converted by copying
+ * their coordinates directly into GEOS coordinate sequences. Other geometry
+ * types, and geometries with M values, are converted through WKB.
+ */
+geom_ptr_r
+ogr_to_geos(GEOSContextHandle_t context, OGRGeometryH geom);
+
+/**
+ * @brief Convert a GEOS geometry to an OGR geometry, which is owned by the caller.
+ *
+ * Coordinates are copied directly from GEOS coordinate sequences. Geometry types
+ * that are not handled directly are converted through WKB.
+ */
+OGRGeometryH
+geos_to_ogr(GEOSContextHandle_t context, const GEOSGeometry* geom);
+
+/**
+ * @brief Convert an OGR geometry to a GEOS geometry using WKB.
+ */
+geom_ptr_r
+ogr_to_geos_wkb(GEOSContextHandle_t context, OGRGeometryH geom);
+
+/**
+ * @brief Convert a GEOS geometry to an OGR geometry using WKB.
+ */
+OGRGeometryH
+geos_to_ogr_wkb(GEOSContextHandle_t context, const GEOSGeometry* geom);
+
+}
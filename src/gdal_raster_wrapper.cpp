@@ -1,4 +1,4 @@
-// Copyright (c) 2018-2023 ISciences, LLC.
+// Copyright (c) 2018-2024 ISciences, LLC.
 // All rights reserved.
 //
 // This software is licensed under the Apache License, Version 2.0 (the "License").
@@ -76,6 +76,16 @@ GDALRasterWrapper::cartesian() const
     return srs == nullptr || !OSRIsGeographic(srs);
 }
 
+std::pair<std::size_t, std::size_t>
+GDALRasterWrapper::block_size() const
+{
+    int block_cols = 1;
+    int block_rows = 1;
+    GDALGetBlockSize(m_band, &block_cols, &block_rows);
+
+    return { static_cast<std::size_t>(std::max(block_rows, 1)), static_cast<std::size_t>(std::max(block_cols, 1)) };
+}
+
 static void
 apply_scale_and_offset(double* px, std::size_t size, double scale, double offset)
 {
@@ -226,14 +236,28 @@ GDALRasterWrapper::compute_raster_grid()
         throw std::runtime_error("Error reading transform");
     }
 
-    double dx = std::abs(adfGeoTransform[1]);
-    double dy = std::abs(adfGeoTransform[5]);
-    double ulx = adfGeoTransform[0];
-    double uly = adfGeoTransform[3];
-
     int nx = GDALGetRasterXSize(m_rast->get());
     int ny = GDALGetRasterYSize(m_rast->get());
 
+    bool north_up = adfGeoTransform[2] == 0 && adfGeoTransform[4] == 0 && adfGeoTransform[1] > 0 && adfGeoTransform[5] < 0;
+
+    if (!north_up) {
+        // Rows and columns are rotated or flipped relative to the coordinate
+        // axes, so define the grid in pixel space and transform features into it.
+        m_transform = AffineTransform::from_geotransform(adfGeoTransform, static_cast<std::size_t>(ny));
+        if (m_transform->determinant() == 0) {
+            throw std::runtime_error("Raster has a degenerate geotransform.");
+        }
+
+        m_grid = { { 0, 0, static_cast<double>(nx), static_cast<double>(ny) }, 1, 1 };
+        return;
+    }
+
+    double dx = adfGeoTransform[1];
+    double dy = -adfGeoTransform[5];
+    double ulx = adfGeoTransform[0];
+    double uly = adfGeoTransform[3];
+
     Box box{ ulx,
              uly - ny * dy,
              ulx + nx * dx,
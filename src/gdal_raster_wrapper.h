@@ -20,6 +20,8 @@
 
 #include <gdal.h>
 
+#include <optional>
+
 namespace exactextract {
 
 class GDALRaster
@@ -64,6 +66,13 @@ class GDALRasterWrapper : public RasterSource
 
     RasterVariant read_box(const Box& box) override;
 
+    std::pair<std::size_t, std::size_t> block_size() const override;
+
+    const AffineTransform* transform() const override
+    {
+        return m_transform ? &*m_transform : nullptr;
+    }
+
     ~GDALRasterWrapper() override;
 
     OGRSpatialReferenceH srs() const;
@@ -76,6 +85,7 @@ class GDALRasterWrapper : public RasterSource
     double m_nodata_value;
     bool m_has_nodata;
     Grid<bounded_extent> m_grid;
+    std::optional<AffineTransform> m_transform;
 
     double m_scale;
     double m_offset;
@@ -0,0 +1,74 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gdal_reprojection.h"
+
+#include <gdal.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace exactextract {
+
+GDALReprojection::GDALReprojection(OGRSpatialReferenceH src, OGRSpatialReferenceH dst)
+{
+    OGRSpatialReferenceH src_gis = OSRClone(src);
+    OGRSpatialReferenceH dst_gis = OSRClone(dst);
+
+#if GDAL_VERSION_MAJOR >= 3
+    OSRSetAxisMappingStrategy(src_gis, OAMS_TRADITIONAL_GIS_ORDER);
+    OSRSetAxisMappingStrategy(dst_gis, OAMS_TRADITIONAL_GIS_ORDER);
+#endif
+
+    m_transform = OCTNewCoordinateTransformation(src_gis, dst_gis);
+
+    OSRRelease(src_gis);
+    OSRRelease(dst_gis);
+
+    if (m_transform == nullptr) {
+        throw std::runtime_error("Failed to create coordinate transformation.");
+    }
+}
+
+GDALReprojection::~GDALReprojection()
+{
+    OCTDestroyCoordinateTransformation(m_transform);
+}
+
+void
+GDALReprojection::apply(double& x, double& y) const
+{
+    apply(1, &x, &y);
+}
+
+void
+GDALReprojection::apply(std::size_t n, double* x, double* y) const
+{
+    if (n == 0) {
+        return;
+    }
+
+    // Coordinates are transformed together, so that the setup performed by
+    // OCTTransform (and PROJ) is shared by all of them.
+    std::vector<int> success(n);
+    bool ok = OCTTransformEx(m_transform, static_cast<int>(n), x, y, nullptr, success.data());
+
+    for (std::size_t i = 0; i < n; i++) {
+        if (!ok || !success[i]) {
+            throw std::runtime_error("Failed to reproject coordinate " + std::to_string(i) + " of " + std::to_string(n) + ".");
+        }
+    }
+}
+
+}
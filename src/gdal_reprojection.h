@@ -0,0 +1,46 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "reprojection.h"
+
+#include <ogr_srs_api.h>
+
+namespace exactextract {
+
+/**
+ * @brief A Reprojection between two spatial reference systems, using an
+ *        OGRCoordinateTransformation. Coordinates are in the traditional
+ *        GIS (longitude, latitude) order regardless of the axis order
+ *        defined by either system.
+ */
+class GDALReprojection : public Reprojection
+{
+  public:
+    GDALReprojection(OGRSpatialReferenceH src, OGRSpatialReferenceH dst);
+
+    GDALReprojection(const GDALReprojection&) = delete;
+    GDALReprojection& operator=(const GDALReprojection&) = delete;
+
+    ~GDALReprojection() override;
+
+    void apply(double& x, double& y) const override;
+
+    void apply(std::size_t n, double* x, double* y) const override;
+
+  private:
+    OGRCoordinateTransformationH m_transform;
+};
+
+}
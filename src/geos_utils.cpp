@@ -13,6 +13,7 @@
 
 #include "geos_utils.h"
 
+#include <exception>
 #include <stdexcept>
 
 namespace exactextract {
@@ -293,4 +294,136 @@ to_coordseq(GEOSContextHandle_t context, const std::vector<Coordinate>& coords)
     return seq;
 }
 
+static geom_ptr_r
+transform_linear(GEOSContextHandle_t context, const GEOSGeometry* g, const std::function<void(std::size_t n, double* x, double* y)>& fn)
+{
+    const GEOSCoordSequence* s = GEOSGeom_getCoordSeq_r(context, g);
+    unsigned int size = geos_get_num_points(context, s);
+
+    std::vector<double> x(size);
+    std::vector<double> y(size);
+
+#if HAVE_3100
+    if (!GEOSCoordSeq_copyToArrays_r(context, s, x.data(), y.data(), nullptr, nullptr)) {
+        throw std::runtime_error("Error reading coordinates.");
+    }
+#else
+    for (unsigned int i = 0; i < size; i++) {
+        if (!GEOSCoordSeq_getX_r(context, s, i, &x[i]) || !GEOSCoordSeq_getY_r(context, s, i, &y[i])) {
+            throw std::runtime_error("Error reading coordinates.");
+        }
+    }
+#endif
+
+    fn(size, x.data(), y.data());
+
+#if HAVE_3100
+    auto seq = geos_ptr(context, GEOSCoordSeq_copyFromArrays_r(context, x.data(), y.data(), nullptr, nullptr, size));
+#else
+    auto seq = GEOSCoordSeq_create_ptr(context, size, 2);
+    for (unsigned int i = 0; i < size; i++) {
+        GEOSCoordSeq_setX_r(context, seq.get(), i, x[i]);
+        GEOSCoordSeq_setY_r(context, seq.get(), i, y[i]);
+    }
+#endif
+
+    switch (GEOSGeomTypeId_r(context, g)) {
+        case GEOS_POINT:
+            return geos_ptr(context, GEOSGeom_createPoint_r(context, seq.release()));
+        case GEOS_LINEARRING:
+            return geos_ptr(context, GEOSGeom_createLinearRing_r(context, seq.release()));
+        default:
+            return geos_ptr(context, GEOSGeom_createLineString_r(context, seq.release()));
+    }
+}
+
+geom_ptr_r
+geos_transform_seq(GEOSContextHandle_t context, const GEOSGeometry* g, const std::function<void(std::size_t n, double* x, double* y)>& fn)
+{
+    if (GEOSisEmpty_r(context, g)) {
+        return geos_ptr(context, GEOSGeom_clone_r(context, g));
+    }
+
+    int type = GEOSGeomTypeId_r(context, g);
+
+    switch (type) {
+        case GEOS_POINT:
+        case GEOS_LINESTRING:
+        case GEOS_LINEARRING:
+            return transform_linear(context, g, fn);
+        case GEOS_POLYGON: {
+            auto shell = transform_linear(context, GEOSGetExteriorRing_r(context, g), fn);
+
+            std::vector<geom_ptr_r> holes;
+            for (int i = 0; i < GEOSGetNumInteriorRings_r(context, g); i++) {
+                holes.push_back(transform_linear(context, GEOSGetInteriorRingN_r(context, g, i), fn));
+            }
+
+            std::vector<GEOSGeometry*> hole_ptrs;
+            for (auto& hole : holes) {
+                hole_ptrs.push_back(hole.release());
+            }
+
+            return geos_ptr(context, GEOSGeom_createPolygon_r(context, shell.release(), hole_ptrs.data(), static_cast<unsigned int>(hole_ptrs.size())));
+        }
+        default: {
+            std::vector<geom_ptr_r> components;
+            for (int i = 0; i < GEOSGetNumGeometries_r(context, g); i++) {
+                components.push_back(geos_transform_seq(context, GEOSGetGeometryN_r(context, g, i), fn));
+            }
+
+            std::vector<GEOSGeometry*> component_ptrs;
+            for (auto& component : components) {
+                component_ptrs.push_back(component.release());
+            }
+
+            return geos_ptr(context, GEOSGeom_createCollection_r(context, type, component_ptrs.data(), static_cast<unsigned int>(component_ptrs.size())));
+        }
+    }
+}
+
+geom_ptr_r
+geos_transform_xy(GEOSContextHandle_t context, const GEOSGeometry* g, const std::function<void(double& x, double& y)>& fn)
+{
+#if HAVE_3110
+    struct CallbackData
+    {
+        const std::function<void(double&, double&)>& fn;
+        std::exception_ptr error;
+    };
+
+    // Exceptions must not propagate through GEOS, so they are stored and
+    // rethrown after the transformation is aborted.
+    auto callback = [](double* x, double* y, void* userdata) -> int {
+        auto* data = static_cast<CallbackData*>(userdata);
+        try {
+            data->fn(*x, *y);
+            return 1;
+        } catch (...) {
+            data->error = std::current_exception();
+            return 0;
+        }
+    };
+
+    CallbackData data{ fn, nullptr };
+    GEOSGeometry* ret = GEOSGeom_transformXY_r(context, g, callback, &data);
+    if (data.error) {
+        if (ret != nullptr) {
+            GEOSGeom_destroy_r(context, ret);
+        }
+        std::rethrow_exception(data.error);
+    }
+    if (ret == nullptr) {
+        throw std::runtime_error("Error transforming geometry.");
+    }
+    return geos_ptr(context, ret);
+#else
+    return geos_transform_seq(context, g, [&fn](std::size_t n, double* x, double* y) {
+        for (std::size_t i = 0; i < n; i++) {
+            fn(x[i], y[i]);
+        }
+    });
+#endif
+}
+
 }
@@ -129,4 +129,21 @@ read(GEOSContextHandle_t context, const GEOSCoordSequence* s);
 seq_ptr_r
 to_coordseq(GEOSContextHandle_t context, const std::vector<Coordinate>& coords);
 
+/**
+ * @brief Return a copy of a geometry with the function `fn` applied to the
+ *        X and Y values of each coordinate. Exceptions thrown by `fn` are
+ *        propagated to the caller.
+ */
+geom_ptr_r
+geos_transform_xy(GEOSContextHandle_t context, const GEOSGeometry* g, const std::function<void(double& x, double& y)>& fn);
+
+/**
+ * @brief Return a copy of a geometry with the function `fn` applied to the
+ *        X and Y values of each coordinate sequence, which are provided as
+ *        separate arrays of `n` values. Z and M values are not retained.
+ *        Exceptions thrown by `fn` are propagated to the caller.
+ */
+geom_ptr_r
+geos_transform_seq(GEOSContextHandle_t context, const GEOSGeometry* g, const std::function<void(std::size_t n, double* x, double* y)>& fn);
+
 }
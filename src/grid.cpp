@@ -89,26 +89,69 @@ make_finite(const Grid<infinite_extent>& grid)
     return { grid.extent(), grid.dx(), grid.dy() };
 }
 
+static std::vector<size_t>
+chunk_starts(size_t n, size_t per_chunk, size_t block, size_t first)
+{
+    // Divide n items into chunks of no more than per_chunk items. Where a chunk
+    // can hold at least one block, its end is moved back to the nearest block
+    // boundary, so that a block is not split between chunks. The first item is
+    // at position `first` within the blocked sequence.
+    std::vector<size_t> starts;
+
+    size_t pos = 0;
+    while (pos < n) {
+        starts.push_back(pos);
+
+        size_t end = pos + per_chunk;
+        if (end < n && block > 1 && per_chunk >= block) {
+            size_t aligned = ((first + end) / block) * block;
+            if (aligned > first + pos) {
+                end = aligned - first;
+            }
+        }
+
+        pos = std::min(end, n);
+    }
+
+    return starts;
+}
+
 std::vector<Grid<bounded_extent>>
 subdivide(const Grid<bounded_extent>& grid, size_t max_size)
+{
+    return subdivide(grid, max_size, 1, 1, 0, 0);
+}
+
+std::vector<Grid<bounded_extent>>
+subdivide(const Grid<bounded_extent>& grid, size_t max_size, size_t block_rows, size_t block_cols, size_t first_row, size_t first_col)
 {
     if (grid.size() < max_size) {
         return { grid };
     }
 
     size_t cols_per_block = std::min(max_size, grid.cols());
+    if (cols_per_block < grid.cols() && block_cols > 1 && cols_per_block >= block_cols) {
+        cols_per_block -= cols_per_block % block_cols;
+    }
+
     size_t rows_per_block = max_size / cols_per_block;
+    if (block_rows > 1 && rows_per_block >= block_rows) {
+        rows_per_block -= rows_per_block % block_rows;
+    }
 
-    size_t col_blocks = (grid.cols() - 1) / cols_per_block + 1;
-    size_t row_blocks = (grid.rows() - 1) / rows_per_block + 1;
+    auto row_starts = chunk_starts(grid.rows(), rows_per_block, block_rows, first_row);
+    auto col_starts = chunk_starts(grid.cols(), cols_per_block, block_cols, first_col);
 
     std::vector<Grid<bounded_extent>> subgrids;
-    for (size_t i = 0; i < row_blocks; i++) {
-        for (size_t j = 0; j < col_blocks; j++) {
-            double xmin = grid.xmin() + grid.dx() * cols_per_block * j;
-            double xmax = j == (col_blocks - 1) ? grid.xmax() : (grid.xmin() + grid.dx() * cols_per_block * (j + 1));
-            double ymax = grid.ymax() - grid.dy() * rows_per_block * i;
-            double ymin = i == (row_blocks - 1) ? grid.ymin() : (grid.ymax() - grid.dy() * rows_per_block * (i + 1));
+    for (size_t i = 0; i < row_starts.size(); i++) {
+        for (size_t j = 0; j < col_starts.size(); j++) {
+            bool last_row = i == (row_starts.size() - 1);
+            bool last_col = j == (col_starts.size() - 1);
+
+            double xmin = grid.xmin() + grid.dx() * static_cast<double>(col_starts[j]);
+            double xmax = last_col ? grid.xmax() : (grid.xmin() + grid.dx() * static_cast<double>(col_starts[j + 1]));
+            double ymax = grid.ymax() - grid.dy() * static_cast<double>(row_starts[i]);
+            double ymin = last_row ? grid.ymin() : (grid.ymax() - grid.dy() * static_cast<double>(row_starts[i + 1]));
 
             Box reduced = { xmin, ymin, xmax, ymax };
             subgrids.emplace_back(reduced, grid.dx(), grid.dy());
@@ -368,6 +368,16 @@ make_finite(const Grid<infinite_extent>& grid);
 std::vector<Grid<bounded_extent>>
 subdivide(const Grid<bounded_extent>& grid, size_t max_size);
 
+/**
+ * @brief Subdivide a grid into subgrids of no more than `max_size` cells,
+ *        placing subgrid boundaries on the edges of the
+ *        `block_rows` x `block_cols` blocks in which the underlying raster
+ *        is stored wherever `max_size` permits. `first_row` and `first_col`
+ *        give the position of the grid's first cell within the blocked raster.
+ */
+std::vector<Grid<bounded_extent>>
+subdivide(const Grid<bounded_extent>& grid, size_t max_size, size_t block_rows, size_t block_cols, size_t first_row, size_t first_col);
+
 template<typename T>
 Grid<bounded_extent>
 common_grid(T begin, T end, double tol = DEFAULT_GRID_COMPAT_TOL)
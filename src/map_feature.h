@@ -151,7 +151,7 @@ class MapFeature : public Feature
     }
 
   private:
-    inline static GEOSContextHandle_t m_geos_context = initGEOS_r(nullptr, nullptr);
+    inline static thread_local GEOSContextHandle_t m_geos_context = initGEOS_r(nullptr, nullptr);
 
     std::unordered_map<std::string, FieldValue> m_map;
     geom_ptr_r m_geom;
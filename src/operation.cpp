@@ -13,6 +13,8 @@
 #include "operation.h"
 #include "utils.h"
 
+#include <iomanip>
+#include <limits>
 #include <sstream>
 
 namespace exactextract {
@@ -256,6 +258,12 @@ class OperationImpl : public Operation
         return true;                                \
     }
 
+#define PER_CELL                   \
+    bool per_cell() const override \
+    {                              \
+        return true;               \
+    }
+
 #define OPERATION(STAT, IMPL, ...)                \
     class STAT : public OperationImpl<STAT>       \
     {                                             \
@@ -271,36 +279,69 @@ class OperationImpl : public Operation
 
 constexpr std::pair<double, double> NAN_PAIR{ std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN() };
 
-OPERATION(CENTER_X, stats.center_x(), REQ_STORED_XY);
-OPERATION(CENTER_Y, stats.center_y(), REQ_STORED_XY);
+/// Converts a cell center from the coordinates of the grid of `rast` to the
+/// coordinates of the features, if they differ.
+static std::pair<double, double>
+feature_xy(const RasterSource* rast, const std::pair<double, double>& xy)
+{
+    const AffineTransform* transform = rast->transform();
+    if (transform == nullptr) {
+        return xy;
+    }
+
+    Coordinate c = transform->apply(xy.first, xy.second);
+    return { c.x, c.y };
+}
+
+/// Returns the X (I = 0) or Y (I = 1) feature coordinates of the stored cell centers.
+template<std::size_t I, typename Stats>
+static std::vector<double>
+feature_centers(const RasterSource* rast, const Stats& stats)
+{
+    const auto& x = stats.center_x();
+    const auto& y = stats.center_y();
+
+    if (rast->transform() == nullptr) {
+        return I == 0 ? x : y;
+    }
+
+    std::vector<double> ret(x.size());
+    for (std::size_t i = 0; i < x.size(); i++) {
+        ret[i] = std::get<I>(feature_xy(rast, { x[i], y[i] }));
+    }
+    return ret;
+}
+
+OPERATION(CENTER_X, feature_centers<0>(values, stats), REQ_STORED_XY PER_CELL);
+OPERATION(CENTER_Y, feature_centers<1>(values, stats), REQ_STORED_XY PER_CELL);
 OPERATION(COUNT, stats.count());
 OPERATION(COV, stats.coefficient_of_variation(), REQ_VARIANCE);
-OPERATION(COVERAGE, stats.coverage_fractions(), REQ_STORED_COV);
+OPERATION(COVERAGE, stats.coverage_fractions(), REQ_STORED_COV PER_CELL);
 OPERATION(MAJORITY, stats.mode(), REQ_HISTOGRAM);
 OPERATION(MAX, stats.max());
-OPERATION(MAX_CENTER_X, stats.max_xy().value_or(NAN_PAIR).first, REQ_STORED_XY);
-OPERATION(MAX_CENTER_Y, stats.max_xy().value_or(NAN_PAIR).second, REQ_STORED_XY);
+OPERATION(MAX_CENTER_X, feature_xy(values, stats.max_xy().value_or(NAN_PAIR)).first, REQ_STORED_XY);
+OPERATION(MAX_CENTER_Y, feature_xy(values, stats.max_xy().value_or(NAN_PAIR)).second, REQ_STORED_XY);
 OPERATION(MEAN, stats.mean());
-OPERATION(MEDIAN, stats.quantile(0.5), REQ_HISTOGRAM);
 OPERATION(MIN, stats.min());
 OPERATION(MINORITY, stats.minority(), REQ_HISTOGRAM);
-OPERATION(MIN_CENTER_X, stats.min_xy().value_or(NAN_PAIR).first, REQ_STORED_XY);
-OPERATION(MIN_CENTER_Y, stats.min_xy().value_or(NAN_PAIR).second, REQ_STORED_XY);
+OPERATION(MIN_CENTER_X, feature_xy(values, stats.min_xy().value_or(NAN_PAIR)).first, REQ_STORED_XY);
+OPERATION(MIN_CENTER_Y, feature_xy(values, stats.min_xy().value_or(NAN_PAIR)).second, REQ_STORED_XY);
 OPERATION(STDEV, stats.stdev(), REQ_VARIANCE);
 OPERATION(SUM, stats.sum());
-OPERATION(VALUES, stats.values(), REQ_STORED_VALUES);
+OPERATION(VALUES, stats.values(), REQ_STORED_VALUES PER_CELL);
 OPERATION(VARIANCE, stats.variance(), REQ_VARIANCE);
 OPERATION(VARIETY, stats.variety(), REQ_HISTOGRAM);
 OPERATION(WEIGHTED_MEAN, stats.weighted_mean());
 OPERATION(WEIGHTED_STDEV, stats.weighted_stdev(), REQ_VARIANCE);
 OPERATION(WEIGHTED_SUM, stats.weighted_sum());
 OPERATION(WEIGHTED_VARIANCE, stats.weighted_variance(), REQ_VARIANCE);
-OPERATION(WEIGHTS, stats.weights(), REQ_STORED_WEIGHTS);
+OPERATION(WEIGHTS, stats.weights(), REQ_STORED_WEIGHTS PER_CELL);
 
 class CellId : public OperationImpl<CellId>
 {
   public:
     REQ_STORED_XY
+    PER_CELL
     using OperationImpl::OperationImpl;
 
     template<typename Stats>
@@ -317,12 +358,77 @@ class CellId : public OperationImpl<CellId>
     }
 };
 
-class Quantile : public OperationImpl<Quantile>
+/// Base class for Operations that compute a quantile. If the "approx" argument
+/// is true, the quantile is computed from a QuantileSketch, whose size is
+/// controlled by the "compression" argument, instead of from a histogram of all
+/// values.
+template<typename Derived>
+class QuantileImpl : public OperationImpl<Derived>
 {
   public:
-    REQ_HISTOGRAM
+    using OperationImpl<Derived>::OperationImpl;
 
-    using OperationImpl::OperationImpl;
+    bool requires_histogram() const override
+    {
+        return !m_approx;
+    }
+
+    bool requires_quantile_sketch() const override
+    {
+        return m_approx;
+    }
+
+    double quantile_sketch_compression() const override
+    {
+        return m_compression;
+    }
+
+  protected:
+    void handle_approx_options(Operation::ArgMap& options)
+    {
+        m_approx = extract_arg<bool>(options, "approx", false);
+        m_compression = QuantileSketch::DEFAULT_COMPRESSION;
+
+        if (m_approx) {
+            m_compression = extract_arg<double>(options, "compression", QuantileSketch::DEFAULT_COMPRESSION);
+            if (!std::isfinite(m_compression) || m_compression < 1) {
+                throw std::invalid_argument("Quantile sketch compression must be at least 1.");
+            }
+        }
+    }
+
+    template<typename Stats>
+    auto get_quantile(const Stats& stats, double q) const
+    {
+        return m_approx ? stats.approx_quantile(q) : stats.quantile(q);
+    }
+
+  private:
+    bool m_approx;
+    double m_compression;
+};
+
+class Median : public QuantileImpl<Median>
+{
+  public:
+    using QuantileImpl::QuantileImpl;
+
+    void handle_options(ArgMap& options)
+    {
+        handle_approx_options(options);
+    }
+
+    template<typename Stats>
+    auto get(const Stats& stats) const
+    {
+        return get_quantile(stats, 0.5);
+    }
+};
+
+class Quantile : public QuantileImpl<Quantile>
+{
+  public:
+    using QuantileImpl::QuantileImpl;
 
     void handle_options(ArgMap& options)
     {
@@ -330,6 +436,8 @@ class Quantile : public OperationImpl<Quantile>
         if (m_quantile < 0 || m_quantile > 1) {
             throw std::invalid_argument("Quantile must be between 0 and 1.");
         }
+
+        handle_approx_options(options);
     }
 
     void set_name(const std::string& p_name)
@@ -340,7 +448,7 @@ class Quantile : public OperationImpl<Quantile>
     template<typename Stats>
     auto get(const Stats& stats) const
     {
-        return stats.quantile(m_quantile);
+        return get_quantile(stats, m_quantile);
     }
 
   private:
@@ -383,6 +491,86 @@ class Frac : public OperationImpl<Frac<Weighted>>
     }
 };
 
+/// Histogram computes the coverage (or weighted coverage) of values falling
+/// into a set of bins, specified either by a colon-separated list of "edges"
+/// or by "bins" equal-width bins between "min" and "max".
+template<bool Weighted>
+class Histogram : public OperationImpl<Histogram<Weighted>>
+{
+  public:
+    Histogram(std::string p_stat,
+              std::string p_name,
+              RasterSource* p_values,
+              RasterSource* p_weights,
+              Operation::ArgMap options)
+      : OperationImpl<Histogram<Weighted>>(p_stat, p_name, p_values, p_weights, options)
+      , m_histogram(parse_bins(options))
+    {
+        // Operations with different bins cannot share a RasterStats, so
+        // edges are written with enough digits to be distinguished.
+        std::stringstream ss;
+        ss << std::setprecision(std::numeric_limits<double>::max_digits10) << "|histogram:";
+        for (double edge : m_histogram.edges()) {
+            ss << edge << ":";
+        }
+        this->m_key += ss.str();
+    }
+
+    // Called from the OperationImpl constructor, which receives a copy of
+    // the arguments. The bins are parsed once, from the constructor's own
+    // arguments, when m_histogram is initialized.
+    void handle_options(Operation::ArgMap& options)
+    {
+        for (const char* arg : { "edges", "bins", "min", "max" }) {
+            options.erase(arg);
+        }
+    }
+
+    const BinnedHistogram* binned_histogram() const override
+    {
+        return &m_histogram;
+    }
+
+    template<typename Stats>
+    auto get(const Stats& stats) const
+    {
+        const auto& hist = stats.binned_histogram();
+
+        if (!hist) {
+            return std::vector<double>(m_histogram.size(), 0.0);
+        }
+
+        if constexpr (Weighted) {
+            return hist->weighted_counts();
+        } else {
+            return hist->counts();
+        }
+    }
+
+  private:
+    static BinnedHistogram parse_bins(Operation::ArgMap& options)
+    {
+        if (options.find("edges") != options.end()) {
+            if (options.find("bins") != options.end() || options.find("min") != options.end() || options.find("max") != options.end()) {
+                throw std::runtime_error("Histogram bins must be specified using either edges or bins, min, and max.");
+            }
+
+            std::vector<double> edges;
+            for (const auto& edge : split(extract_arg<std::string>(options, "edges"), ':')) {
+                edges.push_back(string::read<double>(edge));
+            }
+            return BinnedHistogram(std::move(edges));
+        }
+
+        auto bins = extract_arg<std::size_t>(options, "bins");
+        auto min = extract_arg<double>(options, "min");
+        auto max = extract_arg<double>(options, "max");
+        return BinnedHistogram::fixed_width(min, max, bins);
+    }
+
+    BinnedHistogram m_histogram;
+};
+
 StatDescriptor
 Operation::descriptor() const
 {
@@ -433,6 +621,10 @@ Operation::
         m_coverage_weight_type = CoverageWeightType::AREA_SPHERICAL_M2;
     } else if (coverage_type == "area_spherical_km2") {
         m_coverage_weight_type = CoverageWeightType::AREA_SPHERICAL_KM2;
+    } else if (coverage_type == "area_ellipsoidal_m2") {
+        m_coverage_weight_type = CoverageWeightType::AREA_ELLIPSOIDAL_M2;
+    } else if (coverage_type == "area_ellipsoidal_km2") {
+        m_coverage_weight_type = CoverageWeightType::AREA_ELLIPSOIDAL_KM2;
     } else if (coverage_type == "area_cartesian") {
         m_coverage_weight_type = CoverageWeightType::AREA_CARTESIAN;
     } else {
@@ -522,6 +714,9 @@ Operation::create(std::string stat,
     if (stat == "frac") {
         CONSTRUCT(Frac<false>);
     }
+    if (stat == "histogram") {
+        CONSTRUCT(Histogram<false>);
+    }
     if (stat == "majority" || stat == "mode") {
         CONSTRUCT(MAJORITY);
     }
@@ -538,7 +733,7 @@ Operation::create(std::string stat,
         CONSTRUCT(MEAN);
     }
     if (stat == "median") {
-        CONSTRUCT(MEDIAN);
+        CONSTRUCT(Median);
     }
     if (stat == "min") {
         CONSTRUCT(MIN);
@@ -576,6 +771,9 @@ Operation::create(std::string stat,
     if (stat == "weighted_frac") {
         CONSTRUCT(Frac<true>);
     }
+    if (stat == "weighted_histogram") {
+        CONSTRUCT(Histogram<true>);
+    }
     if (stat == "weighted_mean") {
         CONSTRUCT(WEIGHTED_MEAN);
     }
@@ -630,4 +828,22 @@ Operation::set_empty_result(Feature& f_out) const
 {
     set_result(empty_stats(), f_out);
 }
+
+void
+Operation::add_to_batch(const StatsRegistry& reg, const Feature& f_in) const
+{
+    add_to_batch(reg.contains(f_in, *this) ? reg.stats(f_in, *this) : empty_stats());
+}
+
+void
+Operation::add_to_batch(const StatsRegistry::RasterStatsVariant&) const
+{
+    throw std::runtime_error("Operation " + stat + " does not support batched results.");
+}
+
+void
+Operation::set_batch_results(const std::vector<Feature*>&) const
+{
+    throw std::runtime_error("Operation " + stat + " does not support batched results.");
+}
 }
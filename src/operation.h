@@ -15,6 +15,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "feature.h"
 #include "grid.h"
@@ -74,6 +75,28 @@ class Operation
         return false;
     }
 
+    /// Method which an implementation can override to indicate that `RasterStats`
+    /// should prepare a `QuantileSketch`.
+    virtual bool requires_quantile_sketch() const
+    {
+        return false;
+    }
+
+    /// Returns the compression parameter of the `QuantileSketch` used by this `Operation`,
+    /// if `requires_quantile_sketch` is true.
+    virtual double quantile_sketch_compression() const
+    {
+        return QuantileSketch::DEFAULT_COMPRESSION;
+    }
+
+    /// Method which an implementation can override to indicate that `RasterStats`
+    /// should accumulate a `BinnedHistogram`. Returns an empty histogram defining
+    /// the bins, or `nullptr` if no histogram is needed.
+    virtual const BinnedHistogram* binned_histogram() const
+    {
+        return nullptr;
+    }
+
     /// Method which an implementation can override to indicate that `RasterStats`
     /// should retain the value for every cell it processes.
     virtual bool requires_stored_values() const
@@ -102,6 +125,15 @@ class Operation
         return false;
     }
 
+    /// Method which an implementation can override to indicate that its result is an
+    /// array with one element for each cell processed, such as cell values or coverage
+    /// fractions. Such results can be written in chunks as cells are processed; see
+    /// `Processor::set_stream_cells`.
+    virtual bool per_cell() const
+    {
+        return false;
+    }
+
     virtual bool includes_nodata() const
     {
         return m_include_nodata;
@@ -161,6 +193,25 @@ class Operation
     /// Populates a field in `f_out` with a missing value
     void set_empty_result(Feature& f_out) const;
 
+    /// Returns the maximum number of features whose results are assigned together by
+    /// `set_batch_results`, or zero if the result of each feature is assigned by `set_result`.
+    virtual std::size_t batch_size() const
+    {
+        return 0;
+    }
+
+    /// Records the information needed to compute the result for `f_in`, given a
+    /// `StatsRegistry` to query. The result is assigned by the next call to `set_batch_results`.
+    void add_to_batch(const StatsRegistry& reg, const Feature& f_in) const;
+
+    /// Records the information needed to compute the result for a feature, given a `RasterStats`
+    /// from which to read values.
+    virtual void add_to_batch(const StatsRegistry::RasterStatsVariant& stats) const;
+
+    /// Assigns the results of the features added by `add_to_batch`, in the order in which they
+    /// were added, to `f_out`, and begins a new batch.
+    virtual void set_batch_results(const std::vector<Feature*>& f_out) const;
+
     const ArgMap& options() const
     {
         return m_options;
@@ -0,0 +1,322 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "processing_plan.h"
+
+#include <algorithm>
+#include <ostream>
+#include <string>
+
+namespace exactextract {
+
+template<typename T>
+static const char*
+type_name()
+{
+    if constexpr (std::is_same_v<T, float>) {
+        return "float32";
+    } else if constexpr (std::is_same_v<T, double>) {
+        return "float64";
+    } else if constexpr (std::is_same_v<T, std::int8_t>) {
+        return "int8";
+    } else if constexpr (std::is_same_v<T, std::int16_t>) {
+        return "int16";
+    } else if constexpr (std::is_same_v<T, std::int32_t>) {
+        return "int32";
+    } else if constexpr (std::is_same_v<T, std::int64_t>) {
+        return "int64";
+    } else if constexpr (std::is_same_v<T, std::uint8_t>) {
+        return "uint8";
+    } else if constexpr (std::is_same_v<T, std::uint16_t>) {
+        return "uint16";
+    } else if constexpr (std::is_same_v<T, std::uint32_t>) {
+        return "uint32";
+    } else {
+        return "uint64";
+    }
+}
+
+static std::string
+value_type_name(const RasterSource& rast)
+{
+    return std::visit([](const auto& r) {
+        using value_type = typename std::remove_reference_t<decltype(*r)>::value_type;
+        return std::string(type_name<value_type>());
+    },
+                      rast.read_empty());
+}
+
+static std::size_t
+value_size(const RasterSource& rast)
+{
+    return std::visit([](const auto& r) {
+        using value_type = typename std::remove_reference_t<decltype(*r)>::value_type;
+        return sizeof(value_type);
+    },
+                      rast.read_empty());
+}
+
+static bool
+same_transform(const AffineTransform* a, const AffineTransform* b)
+{
+    return (a == nullptr && b == nullptr) || (a != nullptr && b != nullptr && *a == *b);
+}
+
+/// Returns true if the grids of two rasters use the same coordinates
+static bool
+same_raster_coordinates(const RasterSource& a, const RasterSource& b)
+{
+    return a.reprojection() == b.reprojection() && same_transform(a.transform(), b.transform());
+}
+
+static std::vector<const Operation*>
+pointers(const std::vector<std::unique_ptr<Operation>>& ops)
+{
+    std::vector<const Operation*> ret;
+    for (const auto& op : ops) {
+        ret.push_back(op.get());
+    }
+    return ret;
+}
+
+ProcessingPlan::ProcessingPlan(const std::vector<std::unique_ptr<Operation>>& ops, const StatsRegistry& reg, double grid_compat_tol)
+  : ProcessingPlan(pointers(ops), reg, grid_compat_tol)
+{
+}
+
+ProcessingPlan::ProcessingPlan(const std::vector<const Operation*>& ops, const StatsRegistry& reg, double grid_compat_tol)
+  : m_grid(Grid<bounded_extent>::make_empty())
+{
+    for (const Operation* op : ops) {
+        for (RasterSource* rast : { op->values, op->weights }) {
+            if (rast != nullptr && std::find(m_rasters.begin(), m_rasters.end(), rast) == m_rasters.end()) {
+                m_rasters.push_back(rast);
+            }
+        }
+
+        auto group = std::find_if(m_groups.begin(), m_groups.end(), [op](const OperationGroup& g) {
+            return g.ops.front()->key() == op->key();
+        });
+
+        if (group == m_groups.end()) {
+            m_groups.push_back({ { op }, reg.options(*op) });
+            m_stats_operations.push_back(op);
+        } else {
+            group->ops.push_back(op);
+        }
+    }
+
+    if (!m_rasters.empty()) {
+        const RasterSource& first = *m_rasters.front();
+
+        for (const RasterSource* rast : m_rasters) {
+            if (rast->reprojection() != first.reprojection()) {
+                throw std::runtime_error("Raster " + rast->name() + " does not have the same coordinate reference system as the other rasters.");
+            }
+            if (!same_transform(rast->transform(), first.transform())) {
+                throw std::runtime_error("Raster " + rast->name() + " does not have the same rotation and orientation as the other rasters.");
+            }
+        }
+
+        m_reprojection = first.reprojection();
+        m_transform = first.transform();
+    }
+
+    if (m_transform != nullptr) {
+        for (const Operation* op : ops) {
+            auto weight_type = op->coverage_weight_type();
+            if (weight_type != CoverageWeightType::FRACTION && weight_type != CoverageWeightType::NONE) {
+                throw std::runtime_error("Coverage weights based on cell area cannot be used with a rotated or non-north-up raster.");
+            }
+        }
+    }
+
+    // Computed after checking the transforms so that a mix of rotated and north-up rasters
+    // is not reported as a difference in resolution.
+    m_grid = common_grid(ops.begin(), ops.end(), grid_compat_tol);
+
+    m_reads.resize(m_rasters.size());
+}
+
+std::vector<ProcessingPlan>
+ProcessingPlan::make_plans(const std::vector<std::unique_ptr<Operation>>& ops, const StatsRegistry& reg, double grid_compat_tol)
+{
+    std::vector<std::vector<const Operation*>> groups;
+    std::vector<Grid<bounded_extent>> grids;
+
+    for (const auto& op : ops) {
+        auto grid = op->grid(grid_compat_tol);
+
+        std::size_t i = 0;
+        for (; i < groups.size(); i++) {
+            const Operation& first = *groups[i].front();
+
+            bool same_coords = same_raster_coordinates(*op->values, *first.values) &&
+                               (!op->weighted() || same_raster_coordinates(*op->weights, *first.values));
+
+            if (same_coords && grids[i].compatible_with(grid, grid_compat_tol)) {
+                grids[i] = grids[i].common_grid(grid, grid_compat_tol);
+                groups[i].push_back(op.get());
+                break;
+            }
+        }
+
+        if (i == groups.size()) {
+            groups.push_back({ op.get() });
+            grids.push_back(grid);
+        }
+    }
+
+    std::vector<ProcessingPlan> plans;
+    for (const auto& group : groups) {
+        plans.emplace_back(group, reg, grid_compat_tol);
+    }
+    if (plans.empty()) {
+        plans.emplace_back(std::vector<const Operation*>{}, reg, grid_compat_tol);
+    }
+
+    return plans;
+}
+
+bool
+ProcessingPlan::same_coordinates(const ProcessingPlan& other) const
+{
+    return m_reprojection == other.m_reprojection && same_transform(m_transform, other.m_transform);
+}
+
+std::size_t
+ProcessingPlan::index_of(const RasterSource& rast) const
+{
+    auto it = std::find(m_rasters.begin(), m_rasters.end(), &rast);
+    if (it == m_rasters.end()) {
+        throw std::runtime_error("Raster " + rast.name() + " is not used by this plan.");
+    }
+    return static_cast<std::size_t>(it - m_rasters.begin());
+}
+
+void
+ProcessingPlan::schedule_read(const Box& box)
+{
+    for (std::size_t i = 0; i < m_rasters.size(); i++) {
+        const auto& grid = m_rasters[i]->grid();
+
+        if (grid.extent().intersects(box)) {
+            m_reads[i].reads++;
+            m_reads[i].cells += grid.crop(box).size();
+        }
+    }
+}
+
+std::size_t
+ProcessingPlan::cells_read(const RasterSource& rast) const
+{
+    return m_reads[index_of(rast)].cells;
+}
+
+std::size_t
+ProcessingPlan::bytes_read(const RasterSource& rast) const
+{
+    return cells_read(rast) * value_size(rast);
+}
+
+void
+ProcessingPlan::explain(std::ostream& os) const
+{
+    os << "Grid: " << m_grid.rows() << " rows x " << m_grid.cols() << " cols"
+       << " (dx=" << m_grid.dx() << ", dy=" << m_grid.dy() << ")" << std::endl;
+
+    if (m_reprojection != nullptr) {
+        os << "Features are reprojected to the coordinate reference system of the rasters" << std::endl;
+    }
+
+    if (m_transform != nullptr) {
+        const auto& c = m_transform->coefficients();
+        os << "Grid is in pixel space; features are transformed using ("
+           << c[0] << ", " << c[1] << ", " << c[2] << ", "
+           << c[3] << ", " << c[4] << ", " << c[5] << ")" << std::endl;
+    }
+
+    os << "Rasters:" << std::endl;
+    std::size_t total_bytes = 0;
+    for (std::size_t i = 0; i < m_rasters.size(); i++) {
+        const RasterSource& rast = *m_rasters[i];
+        auto [block_rows, block_cols] = rast.block_size();
+        auto bytes = bytes_read(rast);
+        total_bytes += bytes;
+
+        os << "  " << rast.name() << ": " << value_type_name(rast)
+           << ", " << rast.grid().rows() << " rows x " << rast.grid().cols() << " cols"
+           << ", " << block_rows << "x" << block_cols << " blocks"
+           << "; estimated " << m_reads[i].reads << " reads, "
+           << m_reads[i].cells << " cells, " << bytes << " bytes" << std::endl;
+    }
+    os << "Estimated total bytes read: " << total_bytes << std::endl;
+
+    std::size_t num_ops = 0;
+    for (const auto& group : m_groups) {
+        num_ops += group.ops.size();
+    }
+
+    os << "Operations: " << num_ops << ", computed from " << m_groups.size() << " RasterStats per feature" << std::endl;
+    for (const auto& group : m_groups) {
+        const Operation& first = *group.ops.front();
+        const RasterStatsOptions& opts = group.options;
+
+        os << "  ";
+        for (std::size_t i = 0; i < group.ops.size(); i++) {
+            os << (i == 0 ? "" : ", ") << group.ops[i]->name;
+        }
+
+        os << ": values " << first.values->name();
+        if (first.weighted()) {
+            os << ", weights " << first.weights->name();
+        }
+
+        std::vector<std::string> stored;
+        if (opts.store_histogram) {
+            stored.push_back("histogram");
+        }
+        if (opts.store_quantile_sketch) {
+            stored.push_back("quantile sketch");
+        }
+        if (opts.binned_histogram) {
+            stored.push_back("binned histogram (" + std::to_string(opts.binned_histogram->size()) + " bins)");
+        }
+        if (opts.calc_variance) {
+            stored.push_back("variance");
+        }
+        if (opts.store_values) {
+            stored.push_back("values");
+        }
+        if (opts.store_weights) {
+            stored.push_back("weights");
+        }
+        if (opts.store_coverage_fraction) {
+            stored.push_back("coverage fractions");
+        }
+        if (opts.store_xy) {
+            stored.push_back("cell locations");
+        }
+
+        if (!stored.empty()) {
+            os << "; stores ";
+            for (std::size_t i = 0; i < stored.size(); i++) {
+                os << (i == 0 ? "" : ", ") << stored[i];
+            }
+        }
+
+        os << std::endl;
+    }
+}
+
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+#include "grid.h"
+#include "operation.h"
+#include "raster_source.h"
+#include "stats_registry.h"
+
+namespace exactextract {
+
+/**
+ * @brief The ProcessingPlan class describes the work needed to compute a set of Operations:
+ *        the grid on which they are computed, the distinct rasters that must be read, and the
+ *        groups of Operations that share a `RasterStats` object (those with the same
+ *        `Operation::key()`). Only the first Operation in each group needs to be supplied
+ *        with coverage fractions and raster values. Reads may be added to the plan with
+ *        `schedule_read` to estimate the number of cells and bytes read from each raster.
+ *        Operations whose rasters cannot share a grid are divided among several plans
+ *        by `make_plans`.
+ */
+class ProcessingPlan
+{
+  public:
+    ProcessingPlan(const std::vector<std::unique_ptr<Operation>>& ops, const StatsRegistry& reg, double grid_compat_tol);
+
+    ProcessingPlan(const std::vector<const Operation*>& ops, const StatsRegistry& reg, double grid_compat_tol);
+
+    /**
+     * @brief Divide a set of Operations into plans whose grids can be computed independently.
+     *        Operations are added to the first plan whose grid is compatible with theirs and
+     *        uses the same coordinates, so that rasters with unrelated resolutions, or in
+     *        different coordinate reference systems, can be processed in a single pass over
+     *        the features. At least one plan is always returned.
+     */
+    static std::vector<ProcessingPlan> make_plans(const std::vector<std::unique_ptr<Operation>>& ops, const StatsRegistry& reg, double grid_compat_tol);
+
+    /// Returns true if the grids of this plan and `other` use the same coordinates,
+    /// so that features transformed for one can be used with the other
+    bool same_coordinates(const ProcessingPlan& other) const;
+
+    /// Returns the grid on which all Operations are computed
+    const Grid<bounded_extent>& grid() const
+    {
+        return m_grid;
+    }
+
+    /**
+     * @brief Returns the transformation from the coordinates of `grid()` to the
+     *        coordinates of the features, or `nullptr` if they are the same.
+     *        Features must be transformed into the coordinates of the grid
+     *        (using the inverse transformation) before computing coverage.
+     */
+    const AffineTransform* transform() const
+    {
+        return m_transform;
+    }
+
+    /**
+     * @brief Returns the Reprojection from the coordinate reference system of the
+     *        features to that of the rasters, or `nullptr` if they are the same.
+     *        It is applied before the inverse of `transform()`.
+     */
+    const Reprojection* reprojection() const
+    {
+        return m_reprojection;
+    }
+
+    /// Returns the distinct value and weighting rasters used by the Operations, in the order in which they are first used
+    const std::vector<RasterSource*>& rasters() const
+    {
+        return m_rasters;
+    }
+
+    /// Returns one Operation for each distinct `Operation::key()`, in the order in which they were added
+    const std::vector<const Operation*>& stats_operations() const
+    {
+        return m_stats_operations;
+    }
+
+    /// Records that the portion of each raster intersecting `box` will be read
+    void schedule_read(const Box& box);
+
+    /// Returns the estimated number of cells that will be read from a raster
+    std::size_t cells_read(const RasterSource& rast) const;
+
+    /// Returns the estimated number of bytes that will be read from a raster
+    std::size_t bytes_read(const RasterSource& rast) const;
+
+    /// Writes a human-readable description of the plan
+    void explain(std::ostream& os) const;
+
+  private:
+    struct RasterReads
+    {
+        std::size_t reads = 0;
+        std::size_t cells = 0;
+    };
+
+    struct OperationGroup
+    {
+        std::vector<const Operation*> ops;
+        RasterStatsOptions options;
+    };
+
+    std::size_t index_of(const RasterSource& rast) const;
+
+    Grid<bounded_extent> m_grid;
+    const AffineTransform* m_transform = nullptr;
+    const Reprojection* m_reprojection = nullptr;
+    std::vector<RasterSource*> m_rasters;
+    std::vector<RasterReads> m_reads;
+    std::vector<const Operation*> m_stats_operations;
+    std::vector<OperationGroup> m_groups;
+};
+
+}
@@ -0,0 +1,82 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "processing_profile.h"
+
+#include <iomanip>
+#include <ostream>
+
+namespace exactextract {
+
+const char*
+ProcessingProfile::phase_name(Phase phase)
+{
+    switch (phase) {
+        case Phase::READ_FEATURES:
+            return "read_features";
+        case Phase::READ_RASTERS:
+            return "read_rasters";
+        case Phase::COVERAGE:
+            return "coverage";
+        case Phase::STATS:
+            return "stats";
+        case Phase::WRITE:
+            return "write";
+        case Phase::TOTAL:
+            return "total";
+    }
+
+    return "";
+}
+
+void
+ProcessingProfile::write(std::ostream& os) const
+{
+    auto flags = os.flags();
+    auto precision = os.precision();
+
+    os << std::left << std::setw(16) << "Phase" << std::right << std::setw(12) << "Wall (s)" << std::setw(12) << "CPU (s)" << std::endl;
+    os << std::fixed << std::setprecision(3);
+    for (std::size_t i = 0; i < NUM_PHASES; i++) {
+        os << std::left << std::setw(16) << phase_name(static_cast<Phase>(i)) << std::right << std::setw(12) << m_wall[i] << std::setw(12) << m_cpu[i] << std::endl;
+    }
+
+    os.flags(flags);
+    os.precision(precision);
+
+    os << "Features: " << m_features << " (" << m_features_skipped << " skipped)" << std::endl;
+    os << "Cells read: " << m_cells_read << " (" << m_bytes_read << " bytes)" << std::endl;
+    os << "Cells covered: " << m_cells_covered << std::endl;
+}
+
+void
+ProcessingProfile::write_json(std::ostream& os) const
+{
+    auto precision = os.precision();
+    os << std::setprecision(6);
+
+    os << "{";
+    for (std::size_t i = 0; i < NUM_PHASES; i++) {
+        os << "\"" << phase_name(static_cast<Phase>(i)) << "\": {\"wall\": " << m_wall[i] << ", \"cpu\": " << m_cpu[i] << "}, ";
+    }
+    os << "\"cells_read\": " << m_cells_read << ", ";
+    os << "\"bytes_read\": " << m_bytes_read << ", ";
+    os << "\"cells_covered\": " << m_cells_covered << ", ";
+    os << "\"features\": " << m_features << ", ";
+    os << "\"features_skipped\": " << m_features_skipped;
+    os << "}" << std::endl;
+
+    os.precision(precision);
+}
+
+}
@@ -0,0 +1,193 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <ctime>
+#include <iosfwd>
+
+namespace exactextract {
+
+/**
+ * @brief The ProcessingProfile class records the wall-clock and CPU time spent in
+ *        each phase of processing, along with counts of the work performed. Nothing
+ *        is recorded unless the profile has been enabled.
+ *
+ * CPU time is measured for the whole process, so it includes work performed by
+ * other threads.
+ */
+class ProcessingProfile
+{
+  public:
+    enum class Phase
+    {
+        READ_FEATURES, ///< Reading (and indexing) features from the input dataset
+        READ_RASTERS,  ///< Reading values and weights from rasters
+        COVERAGE,      ///< Computing the coverage fraction of each raster cell
+        STATS,         ///< Updating statistics with covered cells
+        WRITE,         ///< Computing results and writing them to the output
+        TOTAL,         ///< All processing, including time not attributed to another phase
+    };
+
+    static constexpr std::size_t NUM_PHASES = static_cast<std::size_t>(Phase::TOTAL) + 1;
+
+    /**
+     * @brief The Timer class adds the time elapsed between its construction and
+     *        destruction to a phase of a ProcessingProfile.
+     */
+    class Timer
+    {
+      public:
+        Timer(ProcessingProfile* profile, Phase phase)
+          : m_profile(profile != nullptr && profile->enabled() ? profile : nullptr)
+          , m_phase(phase)
+        {
+            if (m_profile != nullptr) {
+                m_wall_start = std::chrono::steady_clock::now();
+                m_cpu_start = std::clock();
+            }
+        }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        ~Timer()
+        {
+            if (m_profile != nullptr) {
+                std::chrono::duration<double> wall = std::chrono::steady_clock::now() - m_wall_start;
+                double cpu = static_cast<double>(std::clock() - m_cpu_start) / CLOCKS_PER_SEC;
+
+                m_profile->add_time(m_phase, wall.count(), cpu);
+            }
+        }
+
+      private:
+        ProcessingProfile* m_profile;
+        Phase m_phase;
+        std::chrono::steady_clock::time_point m_wall_start;
+        std::clock_t m_cpu_start = 0;
+    };
+
+    void set_enabled(bool val)
+    {
+        m_enabled = val;
+    }
+
+    bool enabled() const
+    {
+        return m_enabled;
+    }
+
+    /// Returns a Timer that records time spent in `phase` until it is destroyed
+    Timer time(Phase phase)
+    {
+        return Timer(this, phase);
+    }
+
+    void add_time(Phase phase, double wall_seconds, double cpu_seconds)
+    {
+        auto i = static_cast<std::size_t>(phase);
+        m_wall[i] += wall_seconds;
+        m_cpu[i] += cpu_seconds;
+    }
+
+    /// Records a read of `cells` cells, occupying `bytes` bytes, from a raster
+    void add_read(std::size_t cells, std::size_t bytes)
+    {
+        if (m_enabled) {
+            m_cells_read += cells;
+            m_bytes_read += bytes;
+        }
+    }
+
+    /// Records the coverage of `cells` cells by a feature
+    void add_covered(std::size_t cells)
+    {
+        if (m_enabled) {
+            m_cells_covered += cells;
+        }
+    }
+
+    /// Records the processing of a feature. A feature is "skipped" if it does not
+    /// intersect the extent being processed.
+    void add_feature(bool skipped)
+    {
+        if (m_enabled) {
+            m_features++;
+            m_features_skipped += static_cast<std::size_t>(skipped);
+        }
+    }
+
+    /// Returns the wall-clock time in seconds spent in a phase
+    double wall_seconds(Phase phase) const
+    {
+        return m_wall[static_cast<std::size_t>(phase)];
+    }
+
+    /// Returns the CPU time in seconds spent in a phase
+    double cpu_seconds(Phase phase) const
+    {
+        return m_cpu[static_cast<std::size_t>(phase)];
+    }
+
+    std::size_t cells_read() const
+    {
+        return m_cells_read;
+    }
+
+    std::size_t bytes_read() const
+    {
+        return m_bytes_read;
+    }
+
+    std::size_t cells_covered() const
+    {
+        return m_cells_covered;
+    }
+
+    std::size_t features() const
+    {
+        return m_features;
+    }
+
+    std::size_t features_skipped() const
+    {
+        return m_features_skipped;
+    }
+
+    /// Returns a short name for a phase, such as "read_rasters"
+    static const char* phase_name(Phase phase);
+
+    /// Writes a human-readable summary of the profile
+    void write(std::ostream& os) const;
+
+    /// Writes the profile as a JSON object
+    void write_json(std::ostream& os) const;
+
+  private:
+    bool m_enabled = false;
+
+    std::array<double, NUM_PHASES> m_wall{};
+    std::array<double, NUM_PHASES> m_cpu{};
+
+    std::size_t m_cells_read = 0;
+    std::size_t m_bytes_read = 0;
+    std::size_t m_cells_covered = 0;
+    std::size_t m_features = 0;
+    std::size_t m_features_skipped = 0;
+};
+
+}
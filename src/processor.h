@@ -13,14 +13,30 @@
 
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstdarg>
 #include <functional>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <set>
+#include <stdexcept>
 #include <string>
+#include <tuple>
+#include <variant>
 
 #include "feature_source.h"
 #include "operation.h"
 #include "output_writer.h"
+#include "processing_plan.h"
+#include "processing_profile.h"
+#include "progress_event.h"
+#include "raster_cell_intersection.h"
+#include "raster_source.h"
 #include "stats_registry.h"
 
 static void
@@ -63,8 +79,25 @@ class Processor
 
     virtual void process() = 0;
 
+    /**
+     * @brief Write a description of the work that `process` would perform, including
+     *        estimates of the number of cells and bytes read from each raster, without
+     *        computing any statistics. Features are read from the input dataset in
+     *        order to produce the estimates, after which the dataset is rewound so
+     *        that `process` can be called.
+     */
+    virtual void explain(std::ostream& os) = 0;
+
     void add_operation(const Operation& op)
     {
+        if (m_stream_cells) {
+            check_streamable(op);
+        }
+
+        if (op.batch_size() > 0) {
+            m_batch_size = m_batch_size == 0 ? op.batch_size() : std::min(m_batch_size, op.batch_size());
+        }
+
         m_operations.push_back(op.clone());
         m_reg.prepare(op);
         m_output.add_operation(op);
@@ -94,6 +127,35 @@ class Processor
         m_grid_compat_tol = tol;
     }
 
+    /**
+     * @brief Write the results of per-cell operations (e.g., "values", "coverage") in
+     *        chunks as cells are processed, instead of accumulating them for an entire
+     *        feature. Each chunk is written as a separate feature, containing the
+     *        included columns and geometry of the input feature, so it is most useful
+     *        with an `OutputWriter` that unnests array fields into one row per cell.
+     *        All operations must be per-cell operations.
+     */
+    void set_stream_cells(bool val)
+    {
+        if (val) {
+            for (const auto& op : m_operations) {
+                check_streamable(*op);
+            }
+        }
+
+        m_stream_cells = val;
+    }
+
+    /**
+     * @brief Omit features that do not intersect the grid of any operation from the output,
+     *        instead of writing them with empty statistics. This allows the extent of the
+     *        grids to be used as a spatial filter by the FeatureSource.
+     */
+    void set_omit_features_outside(bool val)
+    {
+        m_omit_features_outside = val;
+    }
+
     void show_progress(bool val)
     {
         m_show_progress = val;
@@ -101,26 +163,156 @@ class Processor
 
     void set_progress_fn(std::function<void(double, std::string_view)> fn)
     {
-        m_progress_fn = fn;
+        if (fn) {
+            m_progress_fn = [fn](const ProgressEvent& event) {
+                fn(event.fraction, event.message);
+            };
+        } else {
+            m_progress_fn = nullptr;
+        }
+    }
+
+    /**
+     * @brief Set a function to be called with a `ProgressEvent`, describing the work
+     *        completed and the rate of processing, each time that progress is reported.
+     *        Progress is only reported if enabled with `show_progress`.
+     */
+    void set_progress_fn(std::function<void(const ProgressEvent&)> fn)
+    {
+        m_progress_fn = std::move(fn);
+    }
+
+    /**
+     * @brief Record the time spent in each phase of `process`, along with the
+     *        number of cells read and covered, in a `ProcessingProfile`.
+     */
+    void collect_profile(bool val)
+    {
+        m_profile.set_enabled(val);
+    }
+
+    const ProcessingProfile& profile() const
+    {
+        return m_profile;
     }
 
     void write_result(const Feature& f_in)
     {
-        auto f_out = m_output.create_feature();
-        if (m_include_geometry) {
-            f_out->set_geometry(f_in.geometry());
+        if (m_stream_cells) {
+            write_stored_cells(f_in);
+
+            // A feature for which no cells were written (e.g., because it is outside
+            // the rasters) is written once with empty results, as when not streaming.
+            if (m_streamed_features.erase(&f_in) == 0) {
+                write_feature(f_in);
+            }
+        } else {
+            write_feature(f_in);
+        }
+        m_reg.flush_feature(f_in);
+        m_features_written++;
+    }
+
+    /**
+     * @brief When streaming cell output, write the cells that have been processed
+     *        for a feature since the last call and release them from the `StatsRegistry`.
+     *        Does nothing if cells are not being streamed.
+     */
+    void write_stored_cells(const Feature& f_in)
+    {
+        if (!m_stream_cells || !m_reg.has_stored_cells(f_in)) {
+            return;
         }
-        for (const auto& col : m_include_cols) {
-            f_out->set(col, f_in);
+
+        write_feature(f_in);
+        m_reg.clear_stored_cells(f_in);
+        m_streamed_features.insert(&f_in);
+    }
+
+    /**
+     * @brief Assign the results of batched operations to the features whose output
+     *        has been deferred, and write them. Must be called after the last feature
+     *        has been processed.
+     */
+    void write_pending_features()
+    {
+        if (m_pending_features.empty()) {
+            return;
         }
+
+        auto timer = m_profile.time(ProcessingProfile::Phase::WRITE);
+
+        std::vector<Feature*> features;
+        features.reserve(m_pending_features.size());
+        for (auto& f_out : m_pending_features) {
+            features.push_back(f_out.get());
+        }
+
         for (const auto& op : m_operations) {
-            op->set_result(m_reg, f_in, *f_out);
+            if (op->batch_size() > 0) {
+                op->set_batch_results(features);
+            }
         }
-        m_output.write(*f_out);
-        m_reg.flush_feature(f_in);
+
+        for (const auto& f_out : m_pending_features) {
+            m_output.write(*f_out);
+        }
+
+        m_pending_features.clear();
     }
 
   protected:
+    void write_feature(const Feature& f_in)
+    {
+        {
+            auto timer = m_profile.time(ProcessingProfile::Phase::WRITE);
+
+            auto f_out = m_output.create_feature();
+            if (m_include_geometry) {
+                f_out->set_geometry(f_in.geometry());
+            }
+            for (const auto& col : m_include_cols) {
+                f_out->set(col, f_in);
+            }
+            for (const auto& op : m_operations) {
+                if (op->batch_size() > 0) {
+                    op->add_to_batch(m_reg, f_in);
+                } else {
+                    op->set_result(m_reg, f_in, *f_out);
+                }
+            }
+
+            if (m_batch_size == 0) {
+                m_output.write(*f_out);
+                return;
+            }
+
+            // Results of batched operations are not available until the batch is complete,
+            // so the feature is held until then.
+            m_pending_features.push_back(std::move(f_out));
+        }
+
+        if (m_pending_features.size() >= m_batch_size) {
+            write_pending_features();
+        }
+    }
+
+    static void check_streamable(const Operation& op)
+    {
+        if (!op.per_cell()) {
+            throw std::runtime_error("Operation \"" + op.stat + "\" does not produce a result for each cell and cannot be used when streaming cell output.");
+        }
+    }
+
+    /// Resets the counters and clock used to report the rate of progress
+    void begin_progress()
+    {
+        m_progress_start = std::chrono::steady_clock::now();
+        m_features_written = 0;
+        m_progress_cells_read = 0;
+        m_progress_bytes_read = 0;
+    }
+
     void progress(double frac, std::string_view message) const
     {
         if (!m_show_progress) {
@@ -128,15 +320,369 @@ class Processor
         }
 
         if (m_progress_fn) {
-            (m_progress_fn)(frac, message);
+            ProgressEvent event;
+            event.fraction = frac;
+            event.message = message;
+            event.features = m_features_written;
+            event.cells_read = m_progress_cells_read;
+            event.bytes_read = m_progress_bytes_read;
+            event.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_progress_start).count();
+
+            (m_progress_fn)(event);
             return;
         }
 
         std::cout << "." << std::flush;
     }
 
+    /// Advances the input dataset to the next feature, recording the time taken in the profile
+    bool next_feature()
+    {
+        auto timer = m_profile.time(ProcessingProfile::Phase::READ_FEATURES);
+        return m_shp.next();
+    }
+
+    /// Reads the portion of a raster within `box`, recording the read in the profile
+    RasterVariant read_box(RasterSource& src, const Box& box)
+    {
+        auto timer = m_profile.time(ProcessingProfile::Phase::READ_RASTERS);
+
+        RasterVariant values = src.read_box(box);
+
+        if (m_show_progress || m_profile.enabled()) {
+            std::visit([this](const auto& r) {
+                using value_type = typename std::remove_reference_t<decltype(*r)>::value_type;
+                std::size_t cells = r->rows() * r->cols();
+                std::size_t bytes = cells * sizeof(value_type);
+
+                m_profile.add_read(cells, bytes);
+                m_progress_cells_read += cells;
+                m_progress_bytes_read += bytes;
+            },
+                       values);
+        }
+
+        return values;
+    }
+
+    /// Computes the coverage fraction of each cell in `grid`, recording the covered cells in the profile
+    Raster<float> compute_coverage(const Grid<bounded_extent>& grid, const GEOSGeometry* g)
+    {
+        Raster<float> coverage = [&]() {
+            auto timer = m_profile.time(ProcessingProfile::Phase::COVERAGE);
+            return raster_cell_intersection(grid, m_geos_context, g);
+        }();
+
+        if (m_profile.enabled()) {
+            std::size_t covered = 0;
+            for (std::size_t i = 0; i < coverage.rows(); i++) {
+                for (std::size_t j = 0; j < coverage.cols(); j++) {
+                    covered += static_cast<std::size_t>(coverage(i, j) > 0);
+                }
+            }
+            m_profile.add_covered(covered);
+        }
+
+        return coverage;
+    }
+
+    /**
+     * @brief Return the coverage with which the unweighted statistics of `op` should be updated.
+     *
+     * When the values raster of an unweighted Operation is coarser than the grid on which coverage
+     * was computed (because a finer raster is used by another Operation), the coverage is aggregated
+     * onto the grid of the values raster, so that statistics are computed once for each cell of the
+     * values raster instead of once for each cell of the finer grid. Aggregated coverage is cached
+     * in `aggregated` by values raster. Coverage is not aggregated onto the rasters in `divided`,
+     * whose cells are divided between subgrids (see divided_rasters).
+     */
+    const Raster<float>& coverage_for(const Operation& op,
+                                      const Raster<float>& coverage,
+                                      const GEOSGeometry* g,
+                                      const std::set<const RasterSource*>& divided,
+                                      std::map<RasterSource*, std::unique_ptr<Raster<float>>>& aggregated)
+    {
+        if (!aggregates_coverage(op, coverage.grid()) || divided.count(op.values)) {
+            return coverage;
+        }
+
+        auto& ret = aggregated[op.values];
+        if (ret == nullptr) {
+            auto timer = m_profile.time(ProcessingProfile::Phase::COVERAGE);
+            bool fractions = GEOSGeom_getDimensions_r(m_geos_context, g) == 2;
+            ret = std::make_unique<Raster<float>>(aggregate_coverage(coverage, op.values->grid(), fractions));
+        }
+
+        return *ret;
+    }
+
+    /// Returns true if the values raster of `op` is coarse enough relative to `grid` that
+    /// coverage computed on `grid` should be aggregated onto it by coverage_for.
+    static bool aggregates_coverage(const Operation& op, const Grid<bounded_extent>& grid)
+    {
+        const auto& values_grid = op.values->grid();
+
+        return !op.weighted() && !grid.empty() && !values_grid.empty() &&
+               (values_grid.dx() >= 1.5 * grid.dx() || values_grid.dy() >= 1.5 * grid.dy());
+    }
+
+    /**
+     * @brief Return the values rasters of the operations of `plan` onto which coverage would be
+     *        aggregated, but whose cells are divided between the `subgrids` of `grid`. A divided
+     *        cell would be passed to the statistics once for each subgrid, with partial coverage,
+     *        so coverage is computed on the finer grid for all subgrids of `grid` instead.
+     */
+    static std::set<const RasterSource*> divided_rasters(const ProcessingPlan& plan,
+                                                         const Grid<bounded_extent>& grid,
+                                                         const std::vector<Grid<bounded_extent>>& subgrids)
+    {
+        std::set<const RasterSource*> ret;
+
+        if (subgrids.size() < 2) {
+            return ret;
+        }
+
+        auto aligned = [](double offset, double res) {
+            double cells = offset / res;
+            return std::abs(cells - std::round(cells)) < 1e-6;
+        };
+
+        for (const Operation* op : plan.stats_operations()) {
+            if (ret.count(op->values) || !aggregates_coverage(*op, grid)) {
+                continue;
+            }
+
+            const auto& values_grid = op->values->grid();
+
+            // Every boundary between subgrids is the left or top edge of some subgrid
+            for (const auto& subgrid : subgrids) {
+                if ((subgrid.xmin() != grid.xmin() && !aligned(subgrid.xmin() - values_grid.xmin(), values_grid.dx())) ||
+                    (subgrid.ymax() != grid.ymax() && !aligned(values_grid.ymax() - subgrid.ymax(), values_grid.dy()))) {
+                    ret.insert(op->values);
+                    break;
+                }
+            }
+        }
+
+        return ret;
+    }
+
+    /**
+     * @brief Return a copy of `g` reprojected and transformed into the coordinates of the
+     *        grid of `plan`, or `nullptr` if the grid uses the coordinates of the features.
+     *        Linear geometries cannot be transformed into the pixel space of a rotated raster
+     *        because their coverage in pixel space would not be proportional to their length.
+     */
+    geom_ptr_r to_grid_coords(const ProcessingPlan& plan, const GEOSGeometry* g)
+    {
+        const Reprojection* reprojection = plan.reprojection();
+        const AffineTransform* transform = plan.transform();
+
+        if ((reprojection == nullptr && transform == nullptr) || g == nullptr) {
+            return geos_ptr(m_geos_context, static_cast<GEOSGeometry*>(nullptr));
+        }
+
+        if (transform != nullptr && GEOSGeom_getDimensions_r(m_geos_context, g) == 1) {
+            throw std::runtime_error("Linear geometries cannot be processed with a rotated or non-north-up raster.");
+        }
+
+        auto timer = m_profile.time(ProcessingProfile::Phase::COVERAGE);
+
+        std::optional<AffineTransform> inv;
+        if (transform != nullptr) {
+            inv = transform->inverse();
+        }
+
+        // Each coordinate sequence is reprojected with a single call, since a
+        // Reprojection may have a significant cost per call.
+        return geos_transform_seq(m_geos_context, g, [reprojection, &inv](std::size_t n, double* x, double* y) {
+            if (reprojection != nullptr) {
+                reprojection->apply(n, x, y);
+            }
+            if (inv) {
+                for (std::size_t i = 0; i < n; i++) {
+                    Coordinate c = inv->apply(x[i], y[i]);
+                    x[i] = c.x;
+                    y[i] = c.y;
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Return `g` in the coordinates of the grid of each plan in `plans`. Plans whose
+     *        grids use the same coordinates share a transformed geometry, which is owned by
+     *        `transformed`. `g` itself is returned for plans whose grids use the coordinates
+     *        of the features.
+     */
+    std::vector<const GEOSGeometry*> to_grid_coords(const std::vector<ProcessingPlan>& plans,
+                                                    const GEOSGeometry* g,
+                                                    std::vector<geom_ptr_r>& transformed)
+    {
+        std::vector<const GEOSGeometry*> ret(plans.size());
+
+        for (std::size_t i = 0; i < plans.size(); i++) {
+            std::size_t j = 0;
+            while (j < i && !plans[j].same_coordinates(plans[i])) {
+                j++;
+            }
+
+            if (j < i) {
+                ret[i] = ret[j];
+                continue;
+            }
+
+            auto geom = to_grid_coords(plans[i], g);
+            ret[i] = geom ? geom.get() : g;
+            if (geom) {
+                transformed.push_back(std::move(geom));
+            }
+        }
+
+        return ret;
+    }
+
+    /**
+     * @brief Return the extent of the grids of `plans` in the coordinates of the features, within
+     *        which the bounding box of a feature must fall for it to be processed, or `std::nullopt`
+     *        if a grid uses different coordinates. If features outside the extent are to be omitted,
+     *        the extent is used as the spatial filter of the FeatureSource.
+     */
+    std::optional<Box> apply_spatial_filter(const std::vector<ProcessingPlan>& plans)
+    {
+        std::optional<Box> extent;
+
+        for (const auto& plan : plans) {
+            if (plan.reprojection() != nullptr || plan.transform() != nullptr) {
+                return std::nullopt;
+            }
+
+            extent = extent ? extent->expand_to_include(plan.grid().extent()) : plan.grid().extent();
+        }
+
+        if (extent && m_omit_features_outside) {
+            m_shp.set_spatial_filter(*extent);
+        }
+
+        return extent;
+    }
+
+    /// Returns true if the bounding box of `f` is known to be outside of `extent`, using the
+    /// envelope of the Feature so that its GEOS geometry need not be constructed.
+    static bool outside(const Feature& f, const std::optional<Box>& extent)
+    {
+        if (!extent) {
+            return false;
+        }
+
+        auto env = f.envelope();
+        return !env || !env->intersects(*extent);
+    }
+
+    /// Group the operations into plans, and compute the cell areas of each plan's grid
+    /// needed by operations whose coverage is weighted by cell area
+    std::vector<ProcessingPlan> make_plans()
+    {
+        auto plans = ProcessingPlan::make_plans(m_operations, m_reg, m_grid_compat_tol);
+
+        for (const auto& plan : plans) {
+            for (const Operation* op : plan.stats_operations()) {
+                m_reg.prepare_cell_areas(*op, plan.grid());
+            }
+        }
+
+        return plans;
+    }
+
+    /**
+     * @brief Subdivide a grid of `plan` into subgrids of no more than m_max_cells_in_memory cells.
+     *        If the values raster of the first operation of the plan has the same resolution as
+     *        the grid, or a resolution that is an integer multiple of it, subgrid boundaries
+     *        are aligned with the blocks of that raster, so that neither its blocks nor
+     *        its cells are divided between subgrids. Where possible, boundaries are also aligned
+     *        with the cells of the coarser rasters onto which coverage is aggregated.
+     */
+    std::vector<Grid<bounded_extent>> subdivide_aligned(const ProcessingPlan& plan, const Grid<bounded_extent>& grid) const
+    {
+        const auto& ops = plan.stats_operations();
+
+        // Subgrid boundaries are placed at rows (columns) of the grid whose position, counted
+        // from `first_row` (`first_col`), is a multiple of `block_rows` (`block_cols`).
+        std::size_t block_rows = 1;
+        std::size_t block_cols = 1;
+        std::size_t first_row = 0;
+        std::size_t first_col = 0;
+
+        auto align_with = [&grid, &block_rows, &block_cols, &first_row, &first_col](const Grid<bounded_extent>& src_grid, std::size_t src_block_rows, std::size_t src_block_cols) {
+            // Number of cells of the grid in each cell of the values raster
+            double ratio_x = src_grid.dx() / grid.dx();
+            double ratio_y = src_grid.dy() / grid.dy();
+            auto rx = static_cast<std::size_t>(std::max(std::lround(ratio_x), 1L));
+            auto ry = static_cast<std::size_t>(std::max(std::lround(ratio_y), 1L));
+
+            bool aligned = (rx == 1 && ry == 1) ? (src_grid.dx() == grid.dx() && src_grid.dy() == grid.dy())
+                                                : (std::abs(ratio_x - static_cast<double>(rx)) < 1e-6 && std::abs(ratio_y - static_cast<double>(ry)) < 1e-6);
+
+            if (!aligned) {
+                return;
+            }
+
+            auto position_in_block = [](double offset, std::size_t block) {
+                auto n = static_cast<long>(block);
+                return static_cast<std::size_t>(((std::lround(offset) % n) + n) % n);
+            };
+
+            std::size_t src_rows = src_block_rows * ry;
+            std::size_t src_cols = src_block_cols * rx;
+
+            auto rows = combine_alignment(block_rows, first_row, src_rows, position_in_block((src_grid.ymax() - grid.ymax()) / grid.dy(), src_rows));
+            auto cols = combine_alignment(block_cols, first_col, src_cols, position_in_block((grid.xmin() - src_grid.xmin()) / grid.dx(), src_cols));
+
+            if (rows && cols) {
+                std::tie(block_rows, first_row) = *rows;
+                std::tie(block_cols, first_col) = *cols;
+            }
+        };
+
+        if (!ops.empty() && ops.front()->values != nullptr && !grid.empty()) {
+            auto [src_block_rows, src_block_cols] = ops.front()->values->block_size();
+            align_with(ops.front()->values->grid(), src_block_rows, src_block_cols);
+
+            for (const Operation* op : ops) {
+                if (aggregates_coverage(*op, grid)) {
+                    align_with(op->values->grid(), 1, 1);
+                }
+            }
+        }
+
+        if (block_rows > 1 || block_cols > 1) {
+            return subdivide(grid, m_max_cells_in_memory, block_rows, block_cols, first_row, first_col);
+        }
+
+        return subdivide(grid, m_max_cells_in_memory);
+    }
+
+    /**
+     * @brief Return the period and offset of the positions that are congruent to both `offset1`
+     *        modulo `period1` and `offset2` modulo `period2`, or `std::nullopt` if there are none.
+     */
+    static std::optional<std::pair<std::size_t, std::size_t>> combine_alignment(std::size_t period1, std::size_t offset1, std::size_t period2, std::size_t offset2)
+    {
+        std::size_t period = std::lcm(period1, period2);
+
+        for (std::size_t offset = offset1; offset < period; offset += period1) {
+            if (offset % period2 == offset2) {
+                return std::make_pair(period, offset);
+            }
+        }
+
+        return std::nullopt;
+    }
+
     StatsRegistry m_reg;
 
+    ProcessingProfile m_profile;
+
     GEOSContextHandle_t m_geos_context;
 
     OutputWriter& m_output;
@@ -145,14 +691,26 @@ class Processor
 
     bool m_show_progress = false;
     bool m_include_geometry = false;
+    bool m_stream_cells = false;
+    bool m_omit_features_outside = false;
 
     std::vector<std::unique_ptr<Operation>> m_operations;
 
+    // Features for which cells have been written while streaming, until their result is written
+    std::set<const Feature*> m_streamed_features;
+
+    std::size_t m_batch_size = 0;
+    std::vector<std::unique_ptr<Feature>> m_pending_features;
+
     std::vector<std::string> m_include_cols;
 
     double m_grid_compat_tol = DEFAULT_GRID_COMPAT_TOL;
     size_t m_max_cells_in_memory = 1000000L;
 
-    std::function<void(double, std::string_view)> m_progress_fn;
+    std::function<void(const ProgressEvent&)> m_progress_fn;
+    std::chrono::steady_clock::time_point m_progress_start = std::chrono::steady_clock::now();
+    std::size_t m_features_written = 0;
+    std::size_t m_progress_cells_read = 0;
+    std::size_t m_progress_bytes_read = 0;
 };
 }
@@ -0,0 +1,76 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace exactextract {
+
+/**
+ * @brief The ProgressEvent struct describes the progress of a `Processor`, including
+ *        the amount of work completed and the rate at which it is being performed.
+ */
+struct ProgressEvent
+{
+    /// Fraction of the work that has been completed, from 0 to 1
+    double fraction = 0;
+
+    /// Description of the current work, such as the feature being processed
+    std::string message;
+
+    /// Number of features whose results have been written
+    std::size_t features = 0;
+
+    /// Number of raster cells read
+    std::size_t cells_read = 0;
+
+    /// Number of bytes of raster values read
+    std::size_t bytes_read = 0;
+
+    /// Wall-clock time in seconds since processing began
+    double elapsed = 0;
+
+    double features_per_second() const
+    {
+        return elapsed > 0 ? static_cast<double>(features) / elapsed : 0;
+    }
+
+    double cells_per_second() const
+    {
+        return elapsed > 0 ? static_cast<double>(cells_read) / elapsed : 0;
+    }
+
+    double bytes_per_second() const
+    {
+        return elapsed > 0 ? static_cast<double>(bytes_read) / elapsed : 0;
+    }
+
+    /// Returns the estimated time in seconds until processing is complete, assuming
+    /// the remaining work proceeds at the same rate. Returns `std::nullopt` if no work
+    /// has been completed.
+    std::optional<double> remaining() const
+    {
+        if (fraction <= 0) {
+            return std::nullopt;
+        }
+        if (fraction >= 1) {
+            return 0.0;
+        }
+        return elapsed * (1 - fraction) / fraction;
+    }
+};
+
+}
@@ -0,0 +1,184 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "quantile_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace exactextract {
+
+static constexpr double PI = 3.14159265358979323846;
+
+QuantileSketch::QuantileSketch(double compression)
+  : m_compression(compression)
+  , m_min(std::numeric_limits<double>::infinity())
+  , m_max(-std::numeric_limits<double>::infinity())
+{
+    if (!std::isfinite(compression) || compression < 1) {
+        throw std::runtime_error("Quantile sketch compression must be at least 1.");
+    }
+}
+
+void
+QuantileSketch::process(double x, double w)
+{
+    if (w < 0) {
+        throw std::runtime_error("Weighted quantile calculation does not support negative weights.");
+    }
+
+    if (!std::isfinite(w)) {
+        throw std::runtime_error("Weighted quantile does not support non-finite weights.");
+    }
+
+    if (w == 0) {
+        return;
+    }
+
+    m_min = std::min(m_min, x);
+    m_max = std::max(m_max, x);
+
+    m_buffer.push_back({ x, w });
+
+    if (static_cast<double>(m_buffer.size()) >= 5 * m_compression) {
+        compress();
+    }
+}
+
+void
+QuantileSketch::merge(const QuantileSketch& other)
+{
+    other.compress();
+
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+
+    m_buffer.insert(m_buffer.end(), other.m_centroids.begin(), other.m_centroids.end());
+
+    compress();
+}
+
+void
+QuantileSketch::compress() const
+{
+    if (m_buffer.empty()) {
+        return;
+    }
+
+    m_buffer.insert(m_buffer.end(), m_centroids.begin(), m_centroids.end());
+    m_centroids.clear();
+
+    std::sort(m_buffer.begin(), m_buffer.end(), [](const Centroid& a, const Centroid& b) {
+        return a.mean < b.mean;
+    });
+
+    double total_weight = 0;
+    for (const auto& c : m_buffer) {
+        total_weight += c.weight;
+    }
+
+    // Scale function k1, which limits the size of centroids near the tails
+    // of the distribution, where quantiles are most sensitive to merging.
+    auto k = [this](double q) {
+        return m_compression / (2 * PI) * std::asin(2 * q - 1);
+    };
+    auto k_inv = [this](double kq) {
+        return (std::sin(std::min(kq * 2 * PI / m_compression, PI / 2)) + 1) / 2;
+    };
+
+    double weight_so_far = 0;
+    double q_limit = k_inv(k(0) + 1);
+
+    Centroid current = m_buffer.front();
+    for (auto it = std::next(m_buffer.begin()); it != m_buffer.end(); ++it) {
+        double q = (weight_so_far + current.weight + it->weight) / total_weight;
+
+        if (q <= q_limit) {
+            current.mean += (it->mean - current.mean) * it->weight / (current.weight + it->weight);
+            current.weight += it->weight;
+        } else {
+            weight_so_far += current.weight;
+            m_centroids.push_back(current);
+
+            q_limit = k_inv(k(weight_so_far / total_weight) + 1);
+            current = *it;
+        }
+    }
+    m_centroids.push_back(current);
+
+    m_buffer.clear();
+}
+
+double
+QuantileSketch::quantile(double q) const
+{
+    if (!std::isfinite(q) || q < 0 || q > 1) {
+        throw std::runtime_error("Quantile must be between 0 and 1.");
+    }
+
+    compress();
+
+    if (m_centroids.empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    if (q == 0) {
+        return m_min;
+    }
+    if (q == 1) {
+        return m_max;
+    }
+
+    // Treat the weight of each centroid as centered on its mean, and interpolate
+    // linearly between centroids. Beyond the first and last centroids, interpolate
+    // toward the observed minimum and maximum.
+    double total_weight = 0;
+    for (const auto& c : m_centroids) {
+        total_weight += c.weight;
+    }
+
+    double target = q * total_weight;
+
+    double prev_x = m_min;
+    double prev_t = 0;
+    double cumsum = 0;
+    for (const auto& c : m_centroids) {
+        double t = cumsum + c.weight / 2;
+
+        if (target < t) {
+            return prev_x + (target - prev_t) * (c.mean - prev_x) / (t - prev_t);
+        }
+
+        prev_x = c.mean;
+        prev_t = t;
+        cumsum += c.weight;
+    }
+
+    if (total_weight == prev_t) {
+        return m_max;
+    }
+
+    return prev_x + (target - prev_t) * (m_max - prev_x) / (total_weight - prev_t);
+}
+
+std::size_t
+QuantileSketch::size() const
+{
+    compress();
+
+    return m_centroids.size();
+}
+
+}
@@ -0,0 +1,70 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace exactextract {
+
+/**
+ * @brief The QuantileSketch class computes approximate weighted quantiles using
+ *        a merging t-digest (Dunning & Ertl, "Computing Extremely Accurate Quantiles
+ *        Using t-Digests", 2019). Memory use is bounded by the compression parameter
+ *        rather than by the number of distinct values processed; larger values of the
+ *        compression parameter retain more centroids and produce more accurate
+ *        quantiles. Quantiles are interpolated linearly between the centers of
+ *        adjacent centroids, and so may differ from those of `WeightedQuantiles`
+ *        even when no centroids have been merged.
+ */
+class QuantileSketch
+{
+  public:
+    static constexpr double DEFAULT_COMPRESSION = 100;
+
+    explicit QuantileSketch(double compression = DEFAULT_COMPRESSION);
+
+    void process(double x, double w);
+
+    /// Add the contents of another sketch to this one
+    void merge(const QuantileSketch& other);
+
+    double quantile(double q) const;
+
+    /// Returns the number of centroids retained by the sketch
+    std::size_t size() const;
+
+    double compression() const
+    {
+        return m_compression;
+    }
+
+  private:
+    struct Centroid
+    {
+        double mean;
+        double weight;
+    };
+
+    void compress() const;
+
+    double m_compression;
+    double m_min;
+    double m_max;
+
+    mutable std::vector<Centroid> m_centroids;
+    mutable std::vector<Centroid> m_buffer;
+};
+
+}
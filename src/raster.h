@@ -13,9 +13,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <limits>
+#include <memory>
 #include <variant>
 
 #include "grid.h"
@@ -385,6 +387,75 @@ class RasterView : public AbstractRaster<T>
         return m_raster(i0, j0);
     }
 
+    /**
+     * @brief Copy the values of the view into a Raster.
+     *
+     * Each cell of the underlying raster is read once and repeated across the
+     * columns and rows of the view that it covers, so that the result can be
+     * accessed without computing the location of each cell in the underlying
+     * raster.
+     */
+    std::unique_ptr<Raster<T>> materialize() const
+    {
+        auto ret = std::make_unique<Raster<T>>(this->grid());
+        if (this->has_nodata()) {
+            ret->set_nodata(this->nodata());
+        }
+
+        const long nrow = static_cast<long>(this->rows());
+        const long ncol = static_cast<long>(this->cols());
+
+        if (nrow == 0 || ncol == 0) {
+            return ret;
+        }
+
+        const T nodata = this->nodata();
+        const long rx = static_cast<long>(m_rx);
+        const long ry = static_cast<long>(m_ry);
+
+        // Columns [col_begin, col_end) of the view fall within the underlying raster
+        long col_begin = 0;
+        long col_end = 0;
+        if (!m_raster.grid().empty()) {
+            col_begin = std::clamp(-m_x_off, 0L, ncol);
+            col_end = std::clamp(static_cast<long>(m_raster.cols()) * rx - m_x_off, col_begin, ncol);
+        }
+
+        long prev_src_row = -1;
+
+        for (long i = 0; i < nrow; i++) {
+            T* out = ret->data().row(static_cast<size_t>(i));
+
+            long src_row_off = i + m_y_off;
+            if (m_raster.grid().empty() || src_row_off < 0 || src_row_off >= static_cast<long>(m_raster.rows()) * ry) {
+                std::fill(out, out + ncol, nodata);
+                prev_src_row = -1;
+                continue;
+            }
+
+            long src_row = src_row_off / ry;
+            if (src_row == prev_src_row) {
+                // Rows of the view within the same row of the underlying raster are identical
+                const T* prev = ret->data().row(static_cast<size_t>(i - 1));
+                std::copy(prev, prev + ncol, out);
+                continue;
+            }
+            prev_src_row = src_row;
+
+            std::fill(out, out + col_begin, nodata);
+            std::fill(out + col_end, out + ncol, nodata);
+
+            for (long j = col_begin; j < col_end;) {
+                long src_col = (j + m_x_off) / rx;
+                long run_end = std::min(col_end, (src_col + 1) * rx - m_x_off);
+                std::fill(out + j, out + run_end, m_raster(static_cast<size_t>(src_row), static_cast<size_t>(src_col)));
+                j = run_end;
+            }
+        }
+
+        return ret;
+    }
+
   private:
     const AbstractRaster<T>& m_raster;
 
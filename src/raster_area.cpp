@@ -0,0 +1,102 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "raster_area.h"
+
+#include <cmath>
+
+namespace exactextract {
+
+static constexpr double PI_180 = 3.141592653589793238462643383279502884197169399375105 / 180;
+
+// Spherical earth
+static constexpr double EARTH_RADIUS = 6378137;
+
+// WGS84 ellipsoid
+static constexpr double WGS84_A = 6378137;
+static constexpr double WGS84_F = 1 / 298.257223563;
+static constexpr double WGS84_B = WGS84_A * (1 - WGS84_F);
+static constexpr double WGS84_E2 = WGS84_F * (2 - WGS84_F);
+
+// Tolerance with which the alignment of grid rows is compared, as a fraction of the row height
+static constexpr double ROW_ALIGNMENT_TOL = 1e-6;
+
+// Area between the equator and latitude phi (radians) of an ellipsoidal zone
+// one radian wide, from the authalic latitude formula
+static double
+wgs84_zone_area(double phi)
+{
+    const double e = std::sqrt(WGS84_E2);
+    const double sin_phi = std::sin(phi);
+
+    return 0.5 * WGS84_B * WGS84_B * (sin_phi / (1 - WGS84_E2 * sin_phi * sin_phi) + std::atanh(e * sin_phi) / e);
+}
+
+double
+LatitudeBandAreas::band_area(Shape shape, double ymin, double ymax)
+{
+    switch (shape) {
+        case Shape::SPHERE:
+            return EARTH_RADIUS * EARTH_RADIUS * PI_180 * std::abs(std::sin(ymin * PI_180) - std::sin(ymax * PI_180));
+        case Shape::WGS84:
+            return PI_180 * std::abs(wgs84_zone_area(ymax * PI_180) - wgs84_zone_area(ymin * PI_180));
+    }
+
+    return 0;
+}
+
+LatitudeBandAreas::LatitudeBandAreas(Shape shape, const Grid<bounded_extent>& grid)
+  : m_shape(shape)
+  , m_dy(grid.dy())
+  , m_ymax(grid.ymax())
+  , m_areas(grid.rows())
+{
+    for (std::size_t i = 0; i < grid.rows(); i++) {
+        double y = grid.y_for_row(i);
+        m_areas[i] = band_area(shape, y - 0.5 * m_dy, y + 0.5 * m_dy);
+    }
+}
+
+std::optional<std::size_t>
+LatitudeBandAreas::rows_per_row(const Grid<bounded_extent>& grid) const
+{
+    double ratio = grid.dy() / m_dy;
+    auto n = std::llround(ratio);
+
+    if (n < 1 || std::abs(ratio - static_cast<double>(n)) > ROW_ALIGNMENT_TOL) {
+        return std::nullopt;
+    }
+
+    return static_cast<std::size_t>(n);
+}
+
+std::optional<std::size_t>
+LatitudeBandAreas::row_offset(const Grid<bounded_extent>& grid) const
+{
+    auto n = rows_per_row(grid);
+    if (!n.has_value()) {
+        return std::nullopt;
+    }
+
+    double offset = (m_ymax - grid.ymax()) / m_dy;
+    auto row = std::llround(offset);
+
+    if (std::abs(offset - static_cast<double>(row)) > ROW_ALIGNMENT_TOL || row < 0 ||
+        static_cast<std::size_t>(row) + grid.rows() * n.value() > m_areas.size()) {
+        return std::nullopt;
+    }
+
+    return static_cast<std::size_t>(row);
+}
+
+}
@@ -13,6 +13,10 @@
 
 #pragma once
 
+#include <memory>
+#include <optional>
+#include <vector>
+
 #include "measures.h"
 #include "raster.h"
 
@@ -38,49 +42,130 @@ class CartesianAreaRaster : public AbstractRaster<T>
     double m_area;
 };
 
+/**
+ * @brief The LatitudeBandAreas class holds the area of a cell one degree wide in
+ *        each row of a geographic grid, on either a sphere or the WGS84 ellipsoid.
+ *
+ * Because the area of a cell depends only on its row, a table is computed once for
+ * a grid (such as the grid of a ProcessingPlan) and used by the area rasters of all
+ * of its subgrids, and of coarser grids whose rows are made up of its rows. The table
+ * is immutable, so it can be shared between threads without synchronization.
+ */
+class LatitudeBandAreas
+{
+  public:
+    enum class Shape
+    {
+        SPHERE,
+        WGS84
+    };
+
+    LatitudeBandAreas(Shape shape, const Grid<bounded_extent>& grid);
+
+    Shape shape() const
+    {
+        return m_shape;
+    }
+
+    /// Return the number of rows of the table spanned by each row of `grid`, or `std::nullopt`
+    /// if the height of a row of `grid` is not a whole multiple of the height of a row of the table.
+    std::optional<std::size_t> rows_per_row(const Grid<bounded_extent>& grid) const;
+
+    /// Return the row of the table corresponding to the first row of `grid`, or `std::nullopt`
+    /// if the rows of `grid` are not each made up of whole rows of the table.
+    std::optional<std::size_t> row_offset(const Grid<bounded_extent>& grid) const;
+
+    /// Return the area, in square meters, of a cell one degree wide in row `i` of the table
+    double operator[](std::size_t i) const
+    {
+        return m_areas[i];
+    }
+
+    /// Compute the area, in square meters, of a cell one degree wide between two latitudes
+    static double band_area(Shape shape, double ymin, double ymax);
+
+  private:
+    Shape m_shape;
+    double m_dy;
+    double m_ymax;
+    std::vector<double> m_areas;
+};
+
 template<typename T>
-class SphericalAreaRaster : public AbstractRaster<T>
+class LatitudeBandAreaRaster : public AbstractRaster<T>
 {
   public:
-    explicit SphericalAreaRaster(const Grid<bounded_extent>& ex, AreaUnit unit)
+    /// Construct a raster of cell areas, using the rows of `table` if the rows of `ex` are made up
+    /// of them, or otherwise computing the areas of the rows of `ex`
+    LatitudeBandAreaRaster(const Grid<bounded_extent>& ex, LatitudeBandAreas::Shape shape, AreaUnit unit, std::shared_ptr<const LatitudeBandAreas> table)
       : AbstractRaster<T>(ex)
-      , m_areas(ex.rows())
+      , m_offset(0)
+      , m_rows_per_row(1)
     {
         const auto& g = AbstractRaster<T>::grid();
 
-        double dlon = g.dx();
-        double dlat = g.dy();
-
-        double factor = 1;
+        m_factor = g.dx();
         switch (unit) {
             case AreaUnit::M2:
-                factor = 1;
                 break;
             case AreaUnit::KM2:
-                factor = 1e-6;
+                m_factor *= 1e-6;
                 break;
         }
 
-        for (size_t i = 0; i < g.rows(); i++) {
-            double y = g.y_for_row(i);
-            double ymin = y - 0.5 * dlat;
-            double ymax = y + 0.5 * dlat;
+        std::optional<std::size_t> offset;
+        if (table != nullptr && table->shape() == shape) {
+            offset = table->row_offset(g);
+        }
 
-            m_areas[i] = EARTH_RADIUS_SQ * PI_180 * std::abs(std::sin(ymin * PI_180) - std::sin(ymax * PI_180)) * dlon * factor;
+        if (offset.has_value()) {
+            m_rows_per_row = table->rows_per_row(g).value();
+            m_table = std::move(table);
+            m_offset = offset.value();
+        } else {
+            m_table = std::make_shared<const LatitudeBandAreas>(shape, g);
         }
     }
 
     T operator()(size_t row, size_t column) const override
     {
         (void)column;
-        return m_areas[row];
+
+        // Band areas are additive, so the area of a row spanning several rows of the table
+        // is the sum of their areas.
+        double area = 0;
+        for (std::size_t i = 0; i < m_rows_per_row; i++) {
+            area += (*m_table)[m_offset + row * m_rows_per_row + i];
+        }
+
+        return static_cast<T>(area * m_factor);
     }
 
   private:
-    static constexpr double EARTH_RADIUS = 6378137;
-    static constexpr double EARTH_RADIUS_SQ = EARTH_RADIUS * EARTH_RADIUS;
-    static constexpr double PI_180 = 3.141592653589793238462643383279502884197169399375105 / 180;
+    std::shared_ptr<const LatitudeBandAreas> m_table;
+    std::size_t m_offset;
+    std::size_t m_rows_per_row;
+    double m_factor;
+};
 
-    std::vector<double> m_areas;
+template<typename T>
+class SphericalAreaRaster : public LatitudeBandAreaRaster<T>
+{
+  public:
+    SphericalAreaRaster(const Grid<bounded_extent>& ex, AreaUnit unit, std::shared_ptr<const LatitudeBandAreas> table = nullptr)
+      : LatitudeBandAreaRaster<T>(ex, LatitudeBandAreas::Shape::SPHERE, unit, std::move(table))
+    {
+    }
 };
+
+template<typename T>
+class EllipsoidalAreaRaster : public LatitudeBandAreaRaster<T>
+{
+  public:
+    EllipsoidalAreaRaster(const Grid<bounded_extent>& ex, AreaUnit unit, std::shared_ptr<const LatitudeBandAreas> table = nullptr)
+      : LatitudeBandAreaRaster<T>(ex, LatitudeBandAreas::Shape::WGS84, unit, std::move(table))
+    {
+    }
+};
+
 }
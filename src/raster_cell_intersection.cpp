@@ -11,6 +11,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cmath>
 #include <stdexcept>
 
 #include <geos_c.h>
@@ -41,6 +42,66 @@ raster_cell_intersection(const Grid<bounded_extent>& raster_grid, const Box& box
              make_finite(rci.m_geometry_grid) };
 }
 
+static long
+floor_div(long a, long b)
+{
+    return a / b - static_cast<long>(a % b != 0 && a < 0);
+}
+
+Raster<float>
+aggregate_coverage(const Raster<float>& coverage, const Grid<bounded_extent>& coarse_grid, bool fractions)
+{
+    if (coverage.rows() == 0 || coverage.cols() == 0) {
+        return Raster<float>(Grid<bounded_extent>::make_empty());
+    }
+
+    double factor_x = coarse_grid.dx() / coverage.xres();
+    double factor_y = coarse_grid.dy() / coverage.yres();
+
+    if (std::abs(factor_x - std::round(factor_x)) > 1e-6 || std::abs(factor_y - std::round(factor_y)) > 1e-6 || factor_x < 1 || factor_y < 1) {
+        throw std::runtime_error("Coverage can only be aggregated to a resolution that is an integer multiple of the original.");
+    }
+
+    const long rx = std::lround(factor_x);
+    const long ry = std::lround(factor_y);
+
+    // Position of the coverage grid relative to the origin of the coarse grid, in units of coverage cells
+    const long col_off = std::lround((coverage.xmin() - coarse_grid.xmin()) / coverage.xres());
+    const long row_off = std::lround((coarse_grid.ymax() - coverage.ymax()) / coverage.yres());
+
+    const long col0 = floor_div(col_off, rx);
+    const long col1 = floor_div(col_off + static_cast<long>(coverage.cols()) - 1, rx);
+    const long row0 = floor_div(row_off, ry);
+    const long row1 = floor_div(row_off + static_cast<long>(coverage.rows()) - 1, ry);
+
+    Box extent{ coarse_grid.xmin() + static_cast<double>(col0) * coarse_grid.dx(),
+                coarse_grid.ymax() - static_cast<double>(row1 + 1) * coarse_grid.dy(),
+                coarse_grid.xmin() + static_cast<double>(col1 + 1) * coarse_grid.dx(),
+                coarse_grid.ymax() - static_cast<double>(row0) * coarse_grid.dy() };
+
+    Raster<float> ret(Grid<bounded_extent>(extent, coarse_grid.dx(), coarse_grid.dy()));
+
+    for (std::size_t i = 0; i < coverage.rows(); i++) {
+        auto ci = static_cast<std::size_t>(floor_div(static_cast<long>(i) + row_off, ry) - row0);
+        for (std::size_t j = 0; j < coverage.cols(); j++) {
+            auto cj = static_cast<std::size_t>(floor_div(static_cast<long>(j) + col_off, rx) - col0);
+            ret(ci, cj) += coverage(i, j);
+        }
+    }
+
+    if (fractions) {
+        // Divide once, so that a fully covered cell has a coverage of exactly 1
+        const auto n = static_cast<float>(rx * ry);
+        for (std::size_t i = 0; i < ret.rows(); i++) {
+            for (std::size_t j = 0; j < ret.cols(); j++) {
+                ret(i, j) /= n;
+            }
+        }
+    }
+
+    return ret;
+}
+
 static Cell*
 get_cell(Matrix<std::unique_ptr<Cell>>& cells, const Grid<infinite_extent>& ex, size_t row, size_t col)
 {
@@ -96,6 +96,21 @@ raster_cell_intersection(const Grid<bounded_extent>& raster_grid, GEOSContextHan
 Raster<float>
 raster_cell_intersection(const Grid<bounded_extent>& raster_grid, const Box& box);
 
+/**
+ * @brief Aggregate coverage computed on one grid onto a coarser grid whose resolution is an
+ *        integer multiple of the original and whose cell boundaries coincide with those of
+ *        the original.
+ *
+ * @param coverage coverage computed on the finer grid
+ * @param coarse_grid grid defining the resolution and alignment of the result. The extent
+ *                    of the result is the set of cells of this grid (extended infinitely, if
+ *                    necessary) that contain a cell of `coverage`.
+ * @param fractions whether `coverage` contains fractions of cells covered by a polygon, which
+ *                  are averaged, or lengths of lines, which are summed.
+ */
+Raster<float>
+aggregate_coverage(const Raster<float>& coverage, const Grid<bounded_extent>& coarse_grid, bool fractions);
+
 /**
  * @brief Determines the bounding box of the raster-vector intersection. Considers the bounding boxes
  *        of individual polygon components separately to avoid unnecessary computation for sparse
@@ -13,10 +13,9 @@
 
 #include "raster_sequential_processor.h"
 #include "operation.h"
-#include "raster_cell_intersection.h"
 #include "raster_source.h"
 
-#include <cassert>
+#include <limits>
 #include <map>
 #include <memory>
 #include <set>
@@ -25,64 +24,151 @@
 namespace exactextract {
 
 void
-RasterSequentialProcessor::read_features()
+RasterSequentialProcessor::read_features(const std::optional<Box>& extent)
 {
-    while (m_shp.next()) {
+    while (next_feature()) {
         const Feature& feature = m_shp.feature();
+
+        if (m_omit_features_outside && outside(feature, extent)) {
+            m_profile.add_feature(true);
+            continue;
+        }
+
         MapFeature mf(feature);
         m_features.push_back(std::move(mf));
     }
 }
 
 void
-RasterSequentialProcessor::populate_index()
+RasterSequentialProcessor::populate_index(const std::vector<ProcessingPlan>& plans)
 {
-    assert(m_feature_tree != nullptr);
-
+    m_grid_geoms.clear();
+    m_transformed_geoms.clear();
     for (const auto& f : m_features) {
-        // TODO compute envelope of dataset, and crop raster by that extent before processing?
-        GEOSSTRtree_insert_r(m_geos_context, m_feature_tree.get(), f.geometry(), (void*)&f);
+        m_transformed_geoms.emplace_back();
+        m_grid_geoms.push_back(to_grid_coords(plans, f.geometry(), m_transformed_geoms.back()));
+    }
+
+    m_feature_trees.clear();
+    for (std::size_t p = 0; p < plans.size(); p++) {
+        m_feature_trees.push_back(geos_ptr(m_geos_context, GEOSSTRtree_create_r(m_geos_context, 10)));
+
+        for (std::size_t i = 0; i < m_features.size(); i++) {
+            // TODO compute envelope of dataset, and crop raster by that extent before processing?
+            if (grid_geometry(p, i) != nullptr) {
+                GEOSSTRtree_insert_r(m_geos_context, m_feature_trees[p].get(), grid_geometry(p, i), (void*)&m_features[i]);
+            }
+        }
+    }
+}
+
+std::vector<const MapFeature*>
+RasterSequentialProcessor::query_features(std::size_t plan, const Box& box) const
+{
+    std::vector<const MapFeature*> hits;
+
+    auto query_rect = geos_make_box_polygon(m_geos_context, box);
+
+    GEOSSTRtree_query_r(
+      m_geos_context, m_feature_trees[plan].get(), query_rect.get(), [](void* hit, void* userdata) {
+          auto feature = static_cast<const MapFeature*>(hit);
+          auto vec = static_cast<std::vector<const MapFeature*>*>(userdata);
+
+          vec->push_back(feature);
+      },
+      &hits);
+
+    return hits;
+}
+
+void
+RasterSequentialProcessor::flush_feature(std::size_t i, bool write)
+{
+    MapFeature& f = m_features[i];
+
+    if (write) {
+        write_result(f);
+    }
+
+    if (f.geometry() != nullptr) {
+        for (std::size_t p = 0; p < m_feature_trees.size(); p++) {
+            GEOSSTRtree_remove_r(m_geos_context, m_feature_trees[p].get(), grid_geometry(p, i), &f);
+        }
     }
+
+    // Release the attributes and geometry of the feature, leaving an empty
+    // placeholder so that pointers to other features remain valid.
+    f = MapFeature();
+    m_grid_geoms[i].clear();
+    m_transformed_geoms[i].clear();
 }
 
 void
 RasterSequentialProcessor::process()
 {
-    read_features();
-    populate_index();
+    auto timer = m_profile.time(ProcessingProfile::Phase::TOTAL);
+    begin_progress();
 
-    auto grid = common_grid(m_operations.begin(), m_operations.end(), m_grid_compat_tol);
+    std::vector<ProcessingPlan> plans = make_plans();
 
-    auto subgrids = subdivide(grid, m_max_cells_in_memory);
-    for (std::size_t i = 0; i < subgrids.size(); i++) {
-        const auto& subgrid = subgrids[i];
-        std::vector<const Feature*> hits;
+    read_features(apply_spatial_filter(plans));
+    {
+        auto index_timer = m_profile.time(ProcessingProfile::Phase::READ_FEATURES);
+        populate_index(plans);
+    }
+
+    // The chunks of each plan's grid, identified by the index of the plan
+    std::vector<std::pair<std::size_t, Grid<bounded_extent>>> subgrids;
+    std::vector<std::set<const RasterSource*>> divided(plans.size());
+    for (std::size_t p = 0; p < plans.size(); p++) {
+        auto plan_subgrids = subdivide_aligned(plans[p], plans[p].grid());
+        divided[p] = divided_rasters(plans[p], plans[p].grid(), plan_subgrids);
+
+        for (const auto& subgrid : plan_subgrids) {
+            subgrids.emplace_back(p, subgrid);
+        }
+    }
 
-        auto query_rect = geos_make_box_polygon(m_geos_context, subgrid.extent());
+    // Subgrids are visited in row-major order. Determine the last subgrid that
+    // each feature intersects, so that its results can be written and its
+    // memory released as soon as the sweep has passed it. Features that do
+    // not intersect any subgrid are written after the first one, unless they
+    // are to be omitted.
+    std::vector<std::vector<std::size_t>> finished_after(subgrids.size());
+    std::vector<bool> intersects_any(m_features.size(), true);
+    {
+        constexpr std::size_t NO_SUBGRID = std::numeric_limits<std::size_t>::max();
 
-        GEOSSTRtree_query_r(
-          m_geos_context, m_feature_tree.get(), query_rect.get(), [](void* hit, void* userdata) {
-              auto feature = static_cast<const Feature*>(hit);
-              auto vec = static_cast<std::vector<const Feature*>*>(userdata);
+        std::vector<std::size_t> last_subgrid(m_features.size(), NO_SUBGRID);
+        for (std::size_t i = 0; i < subgrids.size(); i++) {
+            for (const MapFeature* f : query_features(subgrids[i].first, subgrids[i].second.extent())) {
+                last_subgrid[static_cast<std::size_t>(f - m_features.data())] = i;
+            }
+        }
+
+        for (std::size_t j = 0; j < m_features.size(); j++) {
+            intersects_any[j] = last_subgrid[j] != NO_SUBGRID;
+            m_profile.add_feature(!intersects_any[j]);
+
+            if (!subgrids.empty()) {
+                finished_after[last_subgrid[j] == NO_SUBGRID ? 0 : last_subgrid[j]].push_back(j);
+            }
+        }
+    }
 
-              vec->push_back(feature);
-          },
-          &hits);
+    for (std::size_t i = 0; i < subgrids.size(); i++) {
+        const auto& [p, subgrid] = subgrids[i];
+        const ProcessingPlan& plan = plans[p];
+        auto hits = query_features(p, subgrid.extent());
 
         std::map<RasterSource*, std::unique_ptr<RasterVariant>> raster_values;
 
-        for (const Feature* f : hits) {
+        for (const MapFeature* f : hits) {
+            const GEOSGeometry* geom = grid_geometry(p, static_cast<std::size_t>(f - m_features.data()));
             std::unique_ptr<Raster<float>> coverage;
-            std::set<std::string> processed;
-
-            for (const auto& op : m_operations) {
-                // Avoid processing same values/weights for different stats
-                if (processed.find(op->key()) != processed.end()) {
-                    continue;
-                } else {
-                    processed.insert(op->key());
-                }
+            std::map<RasterSource*, std::unique_ptr<Raster<float>>> aggregated_coverage;
 
+            for (const Operation* op : plan.stats_operations()) {
                 if (!op->values->grid().extent().contains(subgrid.extent())) {
                     continue;
                 }
@@ -93,30 +179,37 @@ RasterSequentialProcessor::process()
 
                 // Lazy-initialize coverage
                 if (coverage == nullptr) {
-                    coverage = std::make_unique<Raster<float>>(
-                      raster_cell_intersection(subgrid, m_geos_context, f->geometry()));
+                    coverage = std::make_unique<Raster<float>>(compute_coverage(subgrid, geom));
                 }
 
                 // FIXME need to ensure that no values are read from a raster that have already been read.
                 // This may be possible when reading box is expanded slightly from floating-point roundoff problems.
                 RasterVariant* values = raster_values[op->values].get();
                 if (values == nullptr) {
-                    raster_values[op->values] = std::make_unique<RasterVariant>(op->values->read_box(subgrid.extent().intersection(op->values->grid().extent())));
+                    raster_values[op->values] = std::make_unique<RasterVariant>(read_box(*op->values, subgrid.extent().intersection(op->values->grid().extent())));
                     values = raster_values[op->values].get();
                 }
 
                 if (op->weighted()) {
                     RasterVariant* weights = raster_values[op->weights].get();
                     if (weights == nullptr) {
-                        raster_values[op->weights] = std::make_unique<RasterVariant>(op->weights->read_box(subgrid.extent().intersection(op->weights->grid().extent())));
+                        raster_values[op->weights] = std::make_unique<RasterVariant>(read_box(*op->weights, subgrid.extent().intersection(op->weights->grid().extent())));
                         weights = raster_values[op->weights].get();
                     }
 
+                    auto stats_timer = m_profile.time(ProcessingProfile::Phase::STATS);
                     m_reg.update_stats(*f, *op, *coverage, *values, *weights);
                 } else {
-                    m_reg.update_stats(*f, *op, *coverage, *values);
+                    auto stats_timer = m_profile.time(ProcessingProfile::Phase::STATS);
+                    m_reg.update_stats(*f, *op, coverage_for(*op, *coverage, geom, divided[p], aggregated_coverage), *values);
                 }
             }
+
+            write_stored_cells(*f);
+        }
+
+        for (std::size_t j : finished_after[i]) {
+            flush_feature(j, intersects_any[j] || !m_omit_features_outside);
         }
 
         if (m_show_progress) {
@@ -126,9 +219,56 @@ RasterSequentialProcessor::process()
         }
     }
 
-    for (const auto& f_in : m_features) {
-        write_result(f_in);
+    if (subgrids.empty()) {
+        for (std::size_t j = 0; j < m_features.size(); j++) {
+            flush_feature(j, !m_omit_features_outside);
+        }
+    }
+
+    write_pending_features();
+
+    m_feature_trees.clear();
+    m_features.clear();
+    m_grid_geoms.clear();
+    m_transformed_geoms.clear();
+}
+
+void
+RasterSequentialProcessor::explain(std::ostream& os)
+{
+    std::vector<ProcessingPlan> plans = make_plans();
+
+    read_features(apply_spatial_filter(plans));
+    populate_index(plans);
+
+    // Rewind the features so that they can be read again by `process`
+    m_shp.reset();
+
+    std::size_t num_subgrids = 0;
+    std::size_t chunks_read = 0;
+    for (std::size_t p = 0; p < plans.size(); p++) {
+        auto subgrids = subdivide_aligned(plans[p], plans[p].grid());
+        num_subgrids += subgrids.size();
+
+        for (const auto& subgrid : subgrids) {
+            if (!query_features(p, subgrid.extent()).empty()) {
+                plans[p].schedule_read(subgrid.extent());
+                chunks_read++;
+            }
+        }
+    }
+
+    os << "Strategy: raster-sequential" << std::endl;
+    os << "Features: " << m_features.size() << std::endl;
+    os << "Chunks: " << num_subgrids << " (" << chunks_read << " intersecting features)" << std::endl;
+    for (const auto& plan : plans) {
+        plan.explain(os);
     }
+
+    m_feature_trees.clear();
+    m_features.clear();
+    m_grid_geoms.clear();
+    m_transformed_geoms.clear();
 }
 
 }
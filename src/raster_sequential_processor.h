@@ -21,23 +21,48 @@ namespace exactextract {
 
 /**
  * @brief The RasterSequentialProcessor class iterates over chunks of the raster, fetching features that intersect each
- * chunk and incrementally updating their statistics. It requires that all features and their associated statistics
- * remain in memory at all times. It may be efficient for rasters that from which random rectangles cannot be
- * efficiently read.
+ * chunk and incrementally updating their statistics. Chunks are visited in row-major order (one grid after another,
+ * if the operations cannot share a single grid), and the results for a feature are written (and its geometry,
+ * attributes, and statistics released) as soon as the last chunk it intersects has been processed. Results are
+ * therefore written in the order in which features are completed, rather than in the order in which they were read.
+ * All features are read before processing begins, so peak memory usage still grows with the number of features.
+ * It may be efficient for rasters that from which random rectangles cannot be efficiently read.
  */
 class RasterSequentialProcessor : public Processor
 {
   public:
     using Processor::Processor;
 
-    void read_features();
-    void populate_index();
+    /// Reads all features into memory. If features outside of the grids are to be omitted,
+    /// features whose envelopes do not intersect `extent` are skipped.
+    void read_features(const std::optional<Box>& extent);
+    void populate_index(const std::vector<ProcessingPlan>& plans);
 
     void process() override;
 
+    void explain(std::ostream& os) override;
+
   private:
+    std::vector<const MapFeature*> query_features(std::size_t plan, const Box& box) const;
+
+    /// Writes the results of the ith feature, if `write` is true, and releases its memory
+    void flush_feature(std::size_t i, bool write);
+
+    /// Returns the geometry of the ith feature in the coordinates of the grid of a plan
+    const GEOSGeometry* grid_geometry(std::size_t plan, std::size_t i) const
+    {
+        return m_grid_geoms[i][plan];
+    }
+
     std::vector<MapFeature> m_features;
-    tree_ptr_r m_feature_tree{ geos_ptr(m_geos_context, GEOSSTRtree_create_r(m_geos_context, 10)) };
+
+    // Geometry of each feature in the coordinates of the grid of each plan, and the
+    // transformed geometries that they reference
+    std::vector<std::vector<const GEOSGeometry*>> m_grid_geoms;
+    std::vector<std::vector<geom_ptr_r>> m_transformed_geoms;
+
+    // Spatial index of features for each plan
+    std::vector<tree_ptr_r> m_feature_trees;
 };
 
 }
@@ -13,9 +13,11 @@
 
 #pragma once
 
+#include "affine_transform.h"
 #include "box.h"
 #include "grid.h"
 #include "raster.h"
+#include "reprojection.h"
 
 namespace exactextract {
 class RasterSource
@@ -24,6 +26,44 @@ class RasterSource
     virtual const Grid<bounded_extent>& grid() const = 0;
     virtual RasterVariant read_box(const Box& box) = 0;
 
+    /**
+     * @brief Return the dimensions (rows, cols) of the blocks in which the
+     *        raster is stored. Reads that do not split blocks avoid reading
+     *        and decompressing a block more than once. Sources with no block
+     *        structure return (1, 1).
+     */
+    virtual std::pair<std::size_t, std::size_t> block_size() const
+    {
+        return { 1, 1 };
+    }
+
+    /**
+     * @brief Return the transformation from the coordinates of `grid()` to
+     *        the coordinates of the features being processed, or `nullptr`
+     *        if the grid is defined in feature coordinates. Sources whose
+     *        pixels are rotated or flipped relative to the feature coordinate
+     *        system define their grid in pixel space and return a transform.
+     */
+    virtual const AffineTransform* transform() const
+    {
+        return nullptr;
+    }
+
+    /**
+     * @brief Return the Reprojection used to transform features into the coordinate
+     *        reference system of the raster, or `nullptr` if the features are already
+     *        in that system.
+     */
+    const Reprojection* reprojection() const
+    {
+        return m_reprojection.get();
+    }
+
+    void set_reprojection(std::shared_ptr<const Reprojection> reprojection)
+    {
+        m_reprojection = std::move(reprojection);
+    }
+
     const RasterVariant& read_empty() const
     {
         if (!m_empty) {
@@ -47,6 +87,7 @@ class RasterSource
 
   private:
     std::string m_name;
+    std::shared_ptr<const Reprojection> m_reprojection;
     mutable std::unique_ptr<RasterVariant> m_empty;
 };
 }
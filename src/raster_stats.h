@@ -14,10 +14,14 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
+#include <memory>
 #include <optional>
-#include <unordered_map>
 
+#include "binned_histogram.h"
+#include "frequency_table.h"
+#include "quantile_sketch.h"
 #include "raster_area.h"
 #include "variance.h"
 #include "weighted_quantiles.h"
@@ -31,6 +35,8 @@ enum class CoverageWeightType
     AREA_CARTESIAN,
     AREA_SPHERICAL_M2,
     AREA_SPHERICAL_KM2,
+    AREA_ELLIPSOIDAL_M2,
+    AREA_ELLIPSOIDAL_KM2,
 };
 
 struct RasterStatsOptions
@@ -40,12 +46,16 @@ struct RasterStatsOptions
     float min_coverage_fraction = min_coverage_fraction_default;
     bool calc_variance = false;
     bool store_histogram = false;
+    bool store_quantile_sketch = false;
+    double quantile_sketch_compression = QuantileSketch::DEFAULT_COMPRESSION;
+    std::optional<BinnedHistogram> binned_histogram = std::nullopt; // empty histogram defining the bins to use
     bool store_values = false;
     bool store_weights = false;
     bool store_coverage_fraction = false;
     bool store_xy = false;
     bool include_nodata = false;
     CoverageWeightType weight_type = CoverageWeightType::FRACTION;
+    std::shared_ptr<const LatitudeBandAreas> cell_areas = nullptr; // areas of the rows of the grid on which coverage is computed
     double default_weight = std::numeric_limits<double>::quiet_NaN();
 };
 
@@ -78,6 +88,8 @@ class RasterStats
       , m_sum_ci{ 0 }
       , m_sum_xici{ 0 }
       , m_sum_xiciwi{ 0 }
+      , m_quantile_sketch{ options.quantile_sketch_compression }
+      , m_binned_histogram{ options.binned_histogram }
       , m_options{ options }
     {
     }
@@ -101,11 +113,11 @@ class RasterStats
         std::unique_ptr<AbstractRaster<T>> rvp;
 
         if (rast.grid() != intersection_percentages.grid()) {
-            rvp = std::make_unique<RasterView<T>>(rast, intersection_percentages.grid());
+            rvp = RasterView<T>(rast, intersection_percentages.grid()).materialize();
         }
 
         const AbstractRaster<T>& rv = rvp ? *rvp : rast;
-        std::unique_ptr<AbstractRaster<float>> areas = area_raster(intersection_percentages.grid(), m_options.weight_type);
+        std::unique_ptr<AbstractRaster<float>> areas = area_raster(intersection_percentages.grid(), m_options.weight_type, m_options.cell_areas);
 
         for (size_t i = 0; i < rv.rows(); i++) {
             for (size_t j = 0; j < rv.cols(); j++) {
@@ -144,18 +156,18 @@ class RasterStats
             return;
 
         // If the value or weights grids do not correspond to the intersection_percentages grid,
-        // construct a RasterView to perform the transformation. Even a no-op RasterView can be
-        // expensive, so we avoid doing this unless necessary.
+        // resample them to the common grid. Reading each cell through a RasterView is expensive,
+        // so the resampled values are copied into a Raster, and we avoid doing this unless necessary.
         std::unique_ptr<AbstractRaster<ValueType>> rvp;
         std::unique_ptr<AbstractRaster<WeightType>> wvp;
-        std::unique_ptr<AbstractRaster<float>> areas = area_raster(common, m_options.weight_type);
+        std::unique_ptr<AbstractRaster<float>> areas = area_raster(common, m_options.weight_type, m_options.cell_areas);
 
         if (rast.grid() != common) {
-            rvp = std::make_unique<RasterView<ValueType>>(rast, common);
+            rvp = RasterView<ValueType>(rast, common).materialize();
         }
 
         if (weights.grid() != common) {
-            wvp = std::make_unique<RasterView<WeightType>>(weights, common);
+            wvp = RasterView<WeightType>(weights, common).materialize();
         }
 
         const AbstractRaster<ValueType>& rv = rvp ? *rvp : rast;
@@ -245,6 +257,14 @@ class RasterStats
             m_quantiles.reset();
         }
 
+        if (m_options.store_quantile_sketch) {
+            m_quantile_sketch.process(static_cast<double>(val), static_cast<double>(coverage));
+        }
+
+        if (m_binned_histogram) {
+            m_binned_histogram->process(static_cast<double>(val), static_cast<double>(coverage), ciwi);
+        }
+
         if (m_options.store_values) {
             m_cell_values.push_back(val);
         }
@@ -254,13 +274,23 @@ class RasterStats
         }
     }
 
-    static std::unique_ptr<AbstractRaster<float>> area_raster(const Grid<bounded_extent>& grid, CoverageWeightType method)
+    /// Return a raster of the cell areas of `grid`, or `nullptr` if coverage is not weighted by cell
+    /// area. The rows of `cell_areas` are used when each row of `grid` is made up of them, including
+    /// when coverage has been aggregated onto a coarser aligned grid. Otherwise (e.g., for a grid
+    /// finer than that of `cell_areas`), the areas are recomputed for each call.
+    static std::unique_ptr<AbstractRaster<float>> area_raster(const Grid<bounded_extent>& grid,
+                                                              CoverageWeightType method,
+                                                              const std::shared_ptr<const LatitudeBandAreas>& cell_areas = nullptr)
     {
         switch (method) {
             case CoverageWeightType::AREA_SPHERICAL_M2:
-                return std::make_unique<SphericalAreaRaster<float>>(grid, AreaUnit::M2);
+                return std::make_unique<SphericalAreaRaster<float>>(grid, AreaUnit::M2, cell_areas);
             case CoverageWeightType::AREA_SPHERICAL_KM2:
-                return std::make_unique<SphericalAreaRaster<float>>(grid, AreaUnit::KM2);
+                return std::make_unique<SphericalAreaRaster<float>>(grid, AreaUnit::KM2, cell_areas);
+            case CoverageWeightType::AREA_ELLIPSOIDAL_M2:
+                return std::make_unique<EllipsoidalAreaRaster<float>>(grid, AreaUnit::M2, cell_areas);
+            case CoverageWeightType::AREA_ELLIPSOIDAL_KM2:
+                return std::make_unique<EllipsoidalAreaRaster<float>>(grid, AreaUnit::KM2, cell_areas);
             case CoverageWeightType::AREA_CARTESIAN:
                 return std::make_unique<ConstantRaster<float>>(grid, grid.dx() * grid.dy());
             case CoverageWeightType::NONE:
@@ -326,12 +356,12 @@ class RasterStats
             return std::nullopt;
         }
 
-        return std::max_element(m_freq.cbegin(),
-                                m_freq.cend(),
-                                [](const auto& a, const auto& b) {
-                                    return a.second.m_sum_ci < b.second.m_sum_ci || (a.second.m_sum_ci == b.second.m_sum_ci && a.first < b.first);
-                                })
-          ->first;
+        return (*std::max_element(m_freq.begin(),
+                                  m_freq.end(),
+                                  [](const auto& a, const auto& b) {
+                                      return a.second.m_sum_ci < b.second.m_sum_ci || (a.second.m_sum_ci == b.second.m_sum_ci && a.first < b.first);
+                                  }))
+          .first;
     }
 
     /**
@@ -406,6 +436,21 @@ class RasterStats
         return m_quantiles->quantile(q);
     }
 
+    /**
+     * An approximation of the given quantile (0-1) of raster cell values,
+     * computed from a QuantileSketch rather than from the histogram of all
+     * values. Coverage fractions are taken into account but weights are not.
+     */
+    std::optional<T>
+    approx_quantile(double q) const
+    {
+        if (m_sum_ci == 0) {
+            return std::nullopt;
+        }
+
+        return m_quantile_sketch.quantile(q);
+    }
+
     /**
      * The sum of raster cells covered by the polygon, with each raster
      * value weighted by its coverage fraction.
@@ -449,13 +494,13 @@ class RasterStats
     std::optional<double>
     count(const T& value) const
     {
-        const auto& entry = m_freq.find(value);
+        const auto* entry = m_freq.find(value);
 
-        if (entry == m_freq.end()) {
+        if (entry == nullptr) {
             return std::nullopt;
         }
 
-        return entry->second.m_sum_ci;
+        return entry->m_sum_ci;
     }
 
     /**
@@ -575,13 +620,13 @@ class RasterStats
     std::optional<double>
     weighted_count(const T& value) const
     {
-        const auto& entry = m_freq.find(value);
+        const auto* entry = m_freq.find(value);
 
-        if (entry == m_freq.end()) {
+        if (entry == nullptr) {
             return std::nullopt;
         }
 
-        return entry->second.m_sum_ciwi;
+        return entry->m_sum_ciwi;
     }
 
     /**
@@ -599,12 +644,12 @@ class RasterStats
             return std::nullopt;
         }
 
-        return std::min_element(m_freq.cbegin(),
-                                m_freq.cend(),
-                                [](const auto& a, const auto& b) {
-                                    return a.second.m_sum_ci < b.second.m_sum_ci || (a.second.m_sum_ci == b.second.m_sum_ci && a.first < b.first);
-                                })
-          ->first;
+        return (*std::min_element(m_freq.begin(),
+                                  m_freq.end(),
+                                  [](const auto& a, const auto& b) {
+                                      return a.second.m_sum_ci < b.second.m_sum_ci || (a.second.m_sum_ci == b.second.m_sum_ci && a.first < b.first);
+                                  }))
+          .first;
     }
 
     /**
@@ -617,13 +662,53 @@ class RasterStats
         return m_freq.size();
     }
 
+    /**
+     * The coverage of values within each bin of the histogram specified by
+     * `RasterStatsOptions::binned_histogram`, or `std::nullopt` if no
+     * histogram was specified.
+     */
+    const std::optional<BinnedHistogram>&
+    binned_histogram() const
+    {
+        return m_binned_histogram;
+    }
+
+    /**
+     * Returns true if values, weights, coverage fractions, or locations
+     * have been stored for any cell.
+     */
+    bool
+    has_stored_cells() const
+    {
+        return !(m_cell_cov.empty() && m_cell_values.empty() && m_cell_weights.empty() && m_cell_x.empty());
+    }
+
+    /**
+     * Discard the values, weights, coverage fractions and locations stored for
+     * each cell, so that the storage can be reused for cells processed later.
+     * Other statistics are unaffected.
+     */
+    void
+    clear_stored_cells()
+    {
+        m_cell_cov.clear();
+        m_cell_values.clear();
+        m_cell_weights.clear();
+        m_cell_x.clear();
+        m_cell_y.clear();
+        m_cell_values_defined.clear();
+        m_cell_weights_defined.clear();
+    }
+
     const std::vector<ValueType>&
     values() const
     {
         return m_cell_values;
     }
 
-    const std::vector<bool>&
+    /// Flags indicating whether each stored value is defined (1) or nodata (0),
+    /// stored one byte per cell so that they can be exposed without conversion.
+    const std::vector<std::uint8_t>&
     values_defined() const
     {
         return m_cell_values_defined;
@@ -641,7 +726,8 @@ class RasterStats
         return m_cell_weights;
     }
 
-    const std::vector<bool>&
+    /// Flags indicating whether each stored weight is defined (1) or nodata (0).
+    const std::vector<std::uint8_t>&
     weights_defined() const
     {
         return m_cell_weights_defined;
@@ -676,21 +762,23 @@ class RasterStats
     WestVariance m_weighted_variance;
 
     mutable std::unique_ptr<WeightedQuantiles> m_quantiles;
+    QuantileSketch m_quantile_sketch;
+    std::optional<BinnedHistogram> m_binned_histogram;
 
     struct ValueFreqEntry
     {
         double m_sum_ci = 0;
         double m_sum_ciwi = 0;
     };
-    std::unordered_map<T, ValueFreqEntry> m_freq;
+    FrequencyTable<T, ValueFreqEntry> m_freq;
 
     std::vector<float> m_cell_cov;
     std::vector<T> m_cell_values;
     std::vector<double> m_cell_weights;
     std::vector<double> m_cell_x;
     std::vector<double> m_cell_y;
-    std::vector<bool> m_cell_values_defined;
-    std::vector<bool> m_cell_weights_defined;
+    std::vector<std::uint8_t> m_cell_values_defined;
+    std::vector<std::uint8_t> m_cell_weights_defined;
 
     const RasterStatsOptionsWithDefault<T> m_options;
 
@@ -698,11 +786,11 @@ class RasterStats
     {
         using iterator_category = std::forward_iterator_tag;
         using difference_type = std::ptrdiff_t;
-        using value_type = const T;
-        using pointer = value_type*;
-        using reference = value_type&;
+        using value_type = T;
+        using pointer = const T*;
+        using reference = T;
 
-        using underlying_iterator = decltype(m_freq.cbegin());
+        using underlying_iterator = typename FrequencyTable<T, ValueFreqEntry>::Iterator;
 
         Iterator(underlying_iterator it)
           : m_iterator(it)
@@ -711,12 +799,7 @@ class RasterStats
 
         reference operator*() const
         {
-            return m_iterator->first;
-        }
-
-        pointer operator->() const
-        {
-            return &(m_iterator->first);
+            return (*m_iterator).first;
         }
 
         // prefix
@@ -751,13 +834,13 @@ class RasterStats
     Iterator
     begin() const
     {
-        return Iterator(m_freq.cbegin());
+        return Iterator(m_freq.begin());
     }
 
     Iterator
     end() const
     {
-        return Iterator(m_freq.cend());
+        return Iterator(m_freq.end());
     }
 };
 
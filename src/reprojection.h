@@ -0,0 +1,46 @@
+// Copyright (c) 2024 ISciences, LLC.
+// All rights reserved.
+//
+// This software is licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License. You may
+// obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+
+namespace exactextract {
+
+/**
+ * @brief A Reprojection transforms coordinates from the coordinate reference
+ *        system of the features being processed to that of a raster.
+ *
+ * Rasters that share a Reprojection object share the reprojected geometry of
+ * each feature, so a single object should be used for all rasters with the
+ * same coordinate reference system.
+ */
+class Reprojection
+{
+  public:
+    virtual ~Reprojection() = default;
+
+    /// Transforms a coordinate in place, throwing an exception if it cannot be transformed
+    virtual void apply(double& x, double& y) const = 0;
+
+    /// Transforms `n` coordinates in place, throwing an exception if any cannot be transformed.
+    /// Implementations for which a call has a significant fixed cost should override this.
+    virtual void apply(std::size_t n, double* x, double* y) const
+    {
+        for (std::size_t i = 0; i < n; i++) {
+            apply(x[i], y[i]);
+        }
+    }
+};
+
+}
@@ -16,6 +16,8 @@
 #include "operation.h"
 #include "raster_stats.h"
 
+#include <algorithm>
+
 namespace exactextract {
 
 void
@@ -25,12 +27,70 @@ StatsRegistry::prepare(const Operation& op)
     // of all Operations returning the same value from Operation::key()
     // Because min_coverage_fraction and weight_type are included in
     // the key, they are set when RasterStats are constructed
-    m_stats_options.store_histogram |= op.requires_histogram();
-    m_stats_options.store_values |= op.requires_stored_values();
-    m_stats_options.store_weights |= op.requires_stored_weights();
-    m_stats_options.store_coverage_fraction |= op.requires_stored_coverage_fractions();
-    m_stats_options.store_xy |= op.requires_stored_locations();
-    m_stats_options.calc_variance |= op.requires_variance();
+    RasterStatsOptions& opts = m_stats_options[op.key()];
+
+    opts.store_histogram |= op.requires_histogram();
+    opts.store_values |= op.requires_stored_values();
+    opts.store_weights |= op.requires_stored_weights();
+    opts.store_coverage_fraction |= op.requires_stored_coverage_fractions();
+    opts.store_xy |= op.requires_stored_locations();
+    opts.calc_variance |= op.requires_variance();
+
+    if (op.requires_quantile_sketch()) {
+        // Use the most accurate sketch requested by any Operation
+        if (opts.store_quantile_sketch) {
+            opts.quantile_sketch_compression = std::max(opts.quantile_sketch_compression, op.quantile_sketch_compression());
+        } else {
+            opts.quantile_sketch_compression = op.quantile_sketch_compression();
+        }
+        opts.store_quantile_sketch = true;
+    }
+
+    // Operations requiring different bins have different keys, so there
+    // is no need to reconcile them here.
+    if (const auto* hist = op.binned_histogram()) {
+        opts.binned_histogram = *hist;
+    }
+}
+
+void
+StatsRegistry::prepare_cell_areas(const Operation& op, const Grid<bounded_extent>& grid)
+{
+    auto it = m_stats_options.find(op.key());
+    if (it == m_stats_options.end()) {
+        return;
+    }
+
+    RasterStatsOptions& opts = it->second;
+
+    LatitudeBandAreas::Shape shape;
+    switch (opts.weight_type) {
+        case CoverageWeightType::AREA_SPHERICAL_M2:
+        case CoverageWeightType::AREA_SPHERICAL_KM2:
+            shape = LatitudeBandAreas::Shape::SPHERE;
+            break;
+        case CoverageWeightType::AREA_ELLIPSOIDAL_M2:
+        case CoverageWeightType::AREA_ELLIPSOIDAL_KM2:
+            shape = LatitudeBandAreas::Shape::WGS84;
+            break;
+        default:
+            return;
+    }
+
+    opts.cell_areas = std::make_shared<const LatitudeBandAreas>(shape, grid);
+}
+
+const RasterStatsOptions&
+StatsRegistry::options(const Operation& op) const
+{
+    static const RasterStatsOptions default_options;
+
+    auto it = m_stats_options.find(op.key());
+    if (it == m_stats_options.end()) {
+        return default_options;
+    }
+
+    return it->second;
 }
 
 void
@@ -75,7 +135,7 @@ StatsRegistry::stats(const Feature& feature, const Operation& op)
         it = std::visit([&stats_for_feature, &op, this](const auto& r) {
                  using value_type = typename std::remove_reference_t<decltype(*r)>::value_type;
 
-                 RasterStatsOptionsWithDefault<value_type> opts{ m_stats_options };
+                 RasterStatsOptionsWithDefault<value_type> opts{ options(op) };
                  opts.min_coverage_fraction = op.min_coverage();
                  opts.weight_type = op.coverage_weight_type();
                  if (op.default_weight().has_value()) {
@@ -109,6 +169,38 @@ StatsRegistry::contains(const Feature& feature, const Operation& op) const
     return m2.find(op.key()) != m2.end();
 }
 
+bool
+StatsRegistry::has_stored_cells(const Feature& feature) const
+{
+    auto it = m_feature_stats.find(&feature);
+
+    if (it == m_feature_stats.end()) {
+        return false;
+    }
+
+    for (const auto& [key, stats] : it->second) {
+        if (std::visit([](const auto& s) { return s.has_stored_cells(); }, stats)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void
+StatsRegistry::clear_stored_cells(const Feature& feature)
+{
+    auto it = m_feature_stats.find(&feature);
+
+    if (it == m_feature_stats.end()) {
+        return;
+    }
+
+    for (auto& [key, stats] : it->second) {
+        std::visit([](auto& s) { s.clear_stored_cells(); }, stats);
+    }
+}
+
 const StatsRegistry::RasterStatsVariant&
 StatsRegistry::stats(const Feature& feature, const Operation& op) const
 {
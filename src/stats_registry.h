@@ -64,8 +64,36 @@ class StatsRegistry
         m_feature_stats.erase(&feature);
     }
 
+    /**
+     * @brief Determine if any `RasterStats` associated with a given feature has stored
+     *        values, weights, coverage fractions, or locations for individual cells.
+     */
+    bool has_stored_cells(const Feature& feature) const;
+
+    /**
+     * @brief Discard the cell values, weights, coverage fractions, and locations stored
+     *        by all `RasterStats` associated with a given feature.
+     */
+    void clear_stored_cells(const Feature& feature);
+
+    /**
+     * @brief Record the `RasterStats` options required by an Operation, so that they
+     *        are provided to every `RasterStats` created for its key.
+     */
     void prepare(const Operation& op);
 
+    /**
+     * @brief Return the options with which `RasterStats` for a given Operation are created.
+     */
+    const RasterStatsOptions& options(const Operation& op) const;
+
+    /**
+     * @brief If the coverage of an Operation is weighted by cell areas that vary by latitude,
+     *        compute the area of each row of `grid`, on which its coverage will be computed, so
+     *        that the areas can be shared by every `RasterStats` created for its key.
+     */
+    void prepare_cell_areas(const Operation& op, const Grid<bounded_extent>& grid);
+
     void update_stats(const Feature& f, const Operation& op, const Raster<float>& coverage, const RasterVariant& values);
 
     void update_stats(const Feature& f, const Operation& op, const Raster<float>& coverage, const RasterVariant& values, const RasterVariant& weights);
@@ -85,6 +113,6 @@ class StatsRegistry
                        std::unordered_map<std::string, RasterStatsVariant>>
       m_feature_stats{};
 
-    RasterStatsOptions m_stats_options;
+    std::unordered_map<std::string, RasterStatsOptions> m_stats_options;
 };
 }
@@ -123,7 +123,7 @@ parse_stat_descriptor(const std::string& p_descriptor)
     }
 
     // Parse stat arguments
-    const std::regex re_args(R"(\(([ ,.=\w-]+)+\)$)");
+    const std::regex re_args(R"(\(([ ,.:=\w-]+)+\)$)");
     std::smatch args_match;
     if (std::regex_search(descriptor, args_match, re_args)) {
         auto args = split(args_match[1].str(), ',');
@@ -14,7 +14,10 @@
 #include "utils_cli.h"
 #include "gdal_raster_wrapper.h"
 
+#include <cmath>
 #include <filesystem>
+#include <iomanip>
+#include <sstream>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -75,10 +78,34 @@ load_gdal_rasters(const std::vector<std::string>& descriptors)
     return raster_sources;
 }
 
+static std::string
+format_duration(double seconds)
+{
+    auto s = static_cast<long long>(std::llround(seconds));
+
+    std::stringstream ss;
+    ss << s / 3600 << ":" << std::setfill('0') << std::setw(2) << (s / 60) % 60 << ":" << std::setw(2) << s % 60;
+    return ss.str();
+}
+
 void
-cli_progress(double frac, std::string_view message)
+cli_progress(const ProgressEvent& event)
 {
-    std::cout << "[" << std::setw(5) << std::fixed << std::setprecision(1) << frac * 100 << "%]  " << message << std::endl
+    std::cout << "[" << std::setw(5) << std::fixed << std::setprecision(1) << event.fraction * 100 << "%]  " << event.message;
+
+    if (event.elapsed > 0) {
+        std::cout << "  (" << std::setprecision(1) << event.features_per_second() << " features/s, "
+                  << std::setprecision(2) << event.cells_per_second() / 1e6 << "M cells/s, "
+                  << event.bytes_read / 1e6 << " MB read";
+
+        auto remaining = event.remaining();
+        if (remaining.has_value()) {
+            std::cout << ", ETA " << format_duration(remaining.value());
+        }
+        std::cout << ")";
+    }
+
+    std::cout << std::endl
               << std::flush;
 }
 
@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include "progress_event.h"
 #include "utils.h"
 #include <string>
 
@@ -21,7 +22,8 @@ namespace exactextract {
 std::vector<std::unique_ptr<RasterSource>>
 load_gdal_rasters(const std::vector<std::string>& descriptors);
 
+/// Prints a line describing the progress of processing to standard output
 void
-cli_progress(double frac, std::string_view message);
+cli_progress(const ProgressEvent& event);
 
 }
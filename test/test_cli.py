@@ -71,7 +71,9 @@ def write_raster(tmp_path):
 
     files = []
 
-    def writer(data, *, mask=None, nodata=None, scale=None, offset=None):
+    def writer(
+        data, *, mask=None, nodata=None, scale=None, offset=None, gt=None, srs=None
+    ):
 
         fname = str(tmp_path / f"raster{len(files)}.tif")
 
@@ -91,7 +93,12 @@ def write_raster(tmp_path):
             bands=nz,
             eType=gdal_array.NumericTypeCodeToGDALTypeCode(data.dtype),
         )
-        ds.SetGeoTransform([0, 1, 0, ny, 0, -1])
+        ds.SetGeoTransform(gt or [0, 1, 0, ny, 0, -1])
+
+        if srs is not None:
+            ogr_srs = osr.SpatialReference()
+            ogr_srs.ImportFromEPSG(srs)
+            ds.SetProjection(ogr_srs.ExportToWkt())
 
         if nz == 1:
             ds.GetRasterBand(1).WriteArray(data)
@@ -182,6 +189,83 @@ def test_multiple_stats(strategy, run, write_raster, write_features):
     assert rows[0]["metric_variety"] == "3"
 
 
+@pytest.mark.parametrize("strategy", ("feature-sequential", "raster-sequential"))
+@pytest.mark.parametrize("orientation", ("south-up", "rotated"))
+def test_rotated_raster(strategy, orientation, run, write_raster, write_features):
+
+    data = np.array([[1, 2, 3, 4], [1, 2, 2, 5], [3, 3, 3, 2]], np.int16)
+    ny = data.shape[0]
+
+    if orientation == "south-up":
+        rotated = write_raster(np.flipud(data), gt=[0, 1, 0, 0, 0, 1])
+    else:
+        # rows increase to the east, columns to the north
+        rotated = write_raster(np.flipud(data).T.copy(), gt=[0, 0, 1, 0, 1, 0])
+
+    features = write_features(
+        {"id": 1, "geom": "POLYGON ((0.5 0.5, 2.5 0.5, 2.5 2, 0.5 2, 0.5 0.5))"}
+    )
+    stats = ["sum(metric)", "min_center_x(metric)", "min_center_y(metric)"]
+
+    expected = run(
+        polygons=features,
+        fid="id",
+        raster=f"metric:{write_raster(data, gt=[0, 1, 0, ny, 0, -1])}",
+        stat=stats,
+        strategy=strategy,
+    )
+
+    rows = run(
+        polygons=features,
+        fid="id",
+        raster=f"metric:{rotated}",
+        stat=stats,
+        strategy=strategy,
+    )
+
+    assert len(rows) == 1
+    for field in ("metric_sum", "metric_min_center_x", "metric_min_center_y"):
+        assert float(rows[0][field]) == pytest.approx(float(expected[0][field]))
+
+
+@pytest.mark.parametrize("strategy", ("feature-sequential", "raster-sequential"))
+def test_features_reprojected_to_raster_crs(
+    strategy, run, write_raster, write_features
+):
+
+    data = np.array([[1, 2, 3, 4], [1, 2, 2, 5], [3, 3, 3, 2]], np.int16)
+
+    # UTM zone 18N
+    utm = osr.SpatialReference()
+    utm.ImportFromEPSG(32618)
+    wgs84 = osr.SpatialReference()
+    wgs84.ImportFromEPSG(4326)
+    for srs in (utm, wgs84):
+        srs.SetAxisMappingStrategy(osr.OAMS_TRADITIONAL_GIS_ORDER)
+
+    # same cells as test_multiple_stats, with 100 m resolution
+    geom = ogr.CreateGeometryFromWkt(
+        "POLYGON ((500050 4500050, 500250 4500050, 500250 4500200, "
+        "500050 4500200, 500050 4500050))"
+    )
+    geom.Transform(osr.CoordinateTransformation(utm, wgs84))
+
+    raster = write_raster(data, gt=[500000, 100, 0, 4500300, 0, -100], srs=32618)
+
+    rows = run(
+        polygons=write_features({"id": 1, "geom": geom.ExportToWkt()}, srs=4326),
+        fid="id",
+        raster=f"metric:{raster}",
+        stat=["mean(metric)", "min_center_x(metric)"],
+        strategy=strategy,
+    )
+
+    assert len(rows) == 1
+    assert float(rows[0]["metric_mean"]) == pytest.approx(2.16667, 1e-3)
+    # cell coordinates are reported in the CRS of the raster
+    assert float(rows[0]["metric_min_center_x"]) == pytest.approx(500050)
+
+
 def test_implicit_syntax(run, write_raster, write_features):
     # Don't provide a name to the raster, and don't reference any raster names
     # in the stat function invocations
@@ -412,6 +496,28 @@ def test_feature_not_intersecting_raster(strategy, run, write_raster, write_feat
     assert rows[0] == {"id": "1", "value_count": "0", "value_mean": "nan"}
 
 
+@pytest.mark.parametrize("strategy", ("feature-sequential", "raster-sequential"))
+def test_omit_features_outside(strategy, run, write_raster, write_features):
+
+    data = np.array([[1, 2, 3], [1, 2, 2], [3, 3, 3]], np.float32)
+
+    rows = run(
+        polygons=write_features(
+            [
+                {"id": 1, "geom": "POLYGON ((100 100, 200 100, 200 200, 100 100))"},
+                {"id": 2, "geom": "POLYGON ((0 0, 3 0, 3 3, 0 3, 0 0))"},
+            ]
+        ),
+        fid="id",
+        raster=f"value:{write_raster(data)}",
+        stat=["count(value)"],
+        strategy=strategy,
+        omit_features_outside=True,
+    )
+
+    assert rows == [{"id": "2", "value_count": "9"}]
+
+
 @pytest.mark.parametrize("strategy", ("feature-sequential", "raster-sequential"))
 @pytest.mark.parametrize("dtype,nodata", [(np.float32, None), (np.int32, -999)])
 def test_feature_intersecting_nodata(
@@ -536,6 +642,89 @@ def test_coverage_fractions(run, write_raster, write_features, strategy):
     assert fracs == [0.25, 0.5, 0.25, 0.5, 1, 0.5, 0.25, 0.5, 0.25]
 
 
+@pytest.mark.parametrize("strategy", ("feature-sequential", "raster-sequential"))
+def test_stream_cells(run, write_raster, write_features, strategy):
+
+    data = np.arange(9, dtype=np.int32).reshape(3, 3)
+
+    square = "POLYGON ((0.5 0.5, 2.5 0.5, 2.5 2.5, 0.5 2.5, 0.5 0.5))"
+    polygons = write_features([{"id": 1, "geom": square}, {"id": 2, "geom": square}])
+    raster = write_raster(data)
+
+    args = dict(
+        polygons=polygons,
+        fid="id",
+        raster=f"rast:{raster}",
+        stat=["coverage(rast)", "cell_id(rast)", "values(rast)"],
+        strategy=strategy,
+        max_cells=0.000002,  # two cells per chunk
+    )
+
+    streamed = run(**args, stream_cells=True)
+    rows = run(**args)
+
+    def for_feature(rows, fid):
+        return [row for row in rows if row["id"] == str(fid)]
+
+    assert len(streamed) == 18
+    for fid in (1, 2):
+        assert for_feature(streamed, fid) == for_feature(rows, fid)
+
+    # Each row of the raster is read in chunks of two cells and one cell
+    def chunk(row):
+        cell = int(row["rast_cell_id"])
+        return 2 * (cell // 3) + (cell % 3) // 2
+
+    if strategy == "raster-sequential":
+        # the cells of both features in each chunk are written before the next chunk
+        chunks = [chunk(row) for row in streamed]
+        assert chunks == sorted(chunks)
+        assert [row["id"] for row in streamed] != sorted(row["id"] for row in streamed)
+    else:
+        # each feature is written in chunks before the next feature is read
+        assert [row["id"] for row in streamed] == ["1"] * 9 + ["2"] * 9
+        for fid in (1, 2):
+            chunks = [chunk(row) for row in for_feature(streamed, fid)]
+            assert chunks == sorted(chunks)
+
+
+@pytest.mark.parametrize("strategy", ("feature-sequential", "raster-sequential"))
+def test_profile_json(run, tmpdir, write_raster, write_features, strategy):
+
+    data = np.arange(9, dtype=np.int32).reshape(3, 3)
+
+    profile_fname = tmpdir / "profile.json"
+
+    rows = run(
+        polygons=write_features(
+            [
+                {
+                    "id": 1,
+                    "geom": "POLYGON ((0.5 0.5, 2.5 0.5, 2.5 2.5, 0.5 2.5, 0.5 0.5))",
+                },
+                {"id": 2, "geom": "POLYGON ((10 10, 11 10, 11 11, 10 10))"},
+            ]
+        ),
+        fid="id",
+        raster=f"rast:{write_raster(data)}",
+        stat="count(rast)",
+        strategy=strategy,
+        profile_json=profile_fname,
+    )
+
+    assert len(rows) == 2
+
+    with open(profile_fname) as f:
+        profile = json.load(f)
+
+    assert profile["features"] == 2
+    assert profile["features_skipped"] == 1
+    assert profile["cells_covered"] == 9
+    assert profile["bytes_read"] == 4 * profile["cells_read"]
+    for phase in ("read_features", "read_rasters", "coverage", "stats", "write"):
+        assert 0 <= profile[phase]["wall"] <= profile["total"]["wall"]
+
+
 def test_coverage_fraction_args(run, write_raster, write_features):
 
     data = np.arange(9, dtype=np.int32).reshape(3, 3)
@@ -726,3 +915,37 @@ def test_gdal_types(gdal_version, dtype, val, run, write_raster, write_features)
     )
 
     assert rows[0]["mode"] == str(val)
+
+
+@pytest.mark.parametrize("strategy", ("feature-sequential", "raster-sequential"))
+def test_explain(strategy, write_raster, write_features):
+
+    data = np.array([[1, 2, 3, 4], [1, 2, 2, 5], [3, 3, 3, 2]], np.int16)
+
+    result = subprocess.run(
+        [
+            "./exactextract",
+            "-p",
+            write_features(
+                {"id": 1, "geom": "POLYGON ((0.5 0.5, 2.5 0.5, 2.5 2, 0.5 2, 0.5 0.5))"}
+            ),
+            "-r",
+            f"metric:{write_raster(data)}",
+            "-s",
+            "mean(metric)",
+            "-s",
+            "median(metric)",
+            "--strategy",
+            strategy,
+            "--explain",
+        ],
+        stdout=subprocess.PIPE,
+        check=True,
+    )
+
+    out = result.stdout.decode()
+
+    assert f"Strategy: {strategy}" in out
+    assert "Features: 1" in out
+    assert "metric: int16, 3 rows x 4 cols" in out
+    assert "metric_mean, metric_median: values metric; stores histogram" in out
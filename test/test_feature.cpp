@@ -1,7 +1,11 @@
 #include <catch.hpp>
 
+#include <cmath>
+
+#include "columnar_feature_source.h"
 #include "map_feature.h"
 
+using exactextract::ColumnarFeatureSource;
 using exactextract::MapFeature;
 
 TEMPLATE_TEST_CASE("32-bit int fields", "[feature]", std::int8_t, std::int16_t, std::int32_t)
@@ -100,3 +104,88 @@ TEMPLATE_TEST_CASE("float array fields", "[feature]", std::vector<float>, std::v
     CHECK(mf.get_double_array("name").size == 3);
     CHECK(mf.get_double_array("name").data[2] == static_cast<typename TestType::value_type>(7.7));
 }
+
+TEST_CASE("columnar feature source", "[feature]")
+{
+    GEOSContextHandle_t context = initGEOS_r(nullptr, nullptr);
+
+    std::vector<std::string> wkb;
+    for (const char* wkt : { "POINT (1 2)", "POLYGON ((0 0, 1 0, 1 1, 0 0))" }) {
+        auto geom = exactextract::GEOSGeom_read_r(context, wkt);
+        std::size_t sz;
+        unsigned char* buf = GEOSGeomToWKB_buf_r(context, geom.get(), &sz);
+        wkb.emplace_back(reinterpret_cast<const char*>(buf), sz);
+        GEOSFree_r(context, buf);
+    }
+
+    ColumnarFeatureSource src(3);
+    src.add_column("name", std::vector<std::string>{ "a", "b", "c" });
+    src.add_column("value", std::vector<double>{ 1.5, 2.5, 3.5 });
+    src.add_column("id", std::vector<std::int64_t>{ 7, 8, 9 });
+    src.set_wkb({ wkb[0], wkb[1], std::string_view() });
+
+    CHECK(src.count() == 3);
+
+    SECTION("features are read from columns")
+    {
+        REQUIRE(src.next());
+        CHECK(src.feature().get_string("name") == "a");
+        CHECK(src.feature().field_type("value") == MapFeature::ValueType::DOUBLE);
+        CHECK(src.feature().get_double("value") == 1.5);
+        CHECK(src.feature().get_int64("id") == 7);
+        CHECK(GEOSGeomTypeId_r(context, src.feature().geometry()) == GEOS_POINT);
+
+        REQUIRE(src.next());
+        CHECK(src.feature().get_string("name") == "b");
+        CHECK(GEOSGeomTypeId_r(context, src.feature().geometry()) == GEOS_POLYGON);
+
+        REQUIRE(src.next());
+        CHECK(src.feature().get_int64("id") == 9);
+        CHECK(src.feature().geometry() == nullptr);
+
+        CHECK(!src.next());
+
+        // source can be read again
+        CHECK(src.next());
+        CHECK(src.feature().get_string("name") == "a");
+    }
+
+    SECTION("features can be copied")
+    {
+        REQUIRE(src.next());
+        REQUIRE(src.next());
+
+        MapFeature mf(src.feature());
+        CHECK(mf.get_string("name") == "b");
+        CHECK(mf.get_double("value") == 2.5);
+        CHECK(mf.get_int64("id") == 8);
+        CHECK(GEOSEquals_r(context, mf.geometry(), src.feature().geometry()));
+    }
+
+    SECTION("missing values are read as NaN")
+    {
+        src.add_column("label", std::vector<std::string>{ "x", "", "z" }, { false, true, false });
+
+        REQUIRE(src.next());
+        CHECK(src.feature().field_type("label") == MapFeature::ValueType::STRING);
+        CHECK(src.feature().get_string("label") == "x");
+
+        REQUIRE(src.next());
+        CHECK(src.feature().field_type("label") == MapFeature::ValueType::DOUBLE);
+        CHECK(std::isnan(src.feature().get_double("label")));
+
+        MapFeature mf(src.feature());
+        CHECK(std::isnan(mf.get_double("label")));
+    }
+
+    SECTION("errors")
+    {
+        REQUIRE(src.next());
+
+        CHECK_THROWS_WITH(src.feature().get_double("name"), Catch::Contains("not of the requested type"));
+        CHECK_THROWS_WITH(src.feature().get_double("missing"), Catch::Contains("No field named"));
+        CHECK_THROWS_WITH(src.add_column("short", std::vector<double>{ 1.0 }), Catch::Contains("3 features were expected"));
+    }
+
+    finishGEOS_r(context);
+}
@@ -1,6 +1,7 @@
 #include "catch.hpp"
 #include "gdal_feature.h"
 #include "gdal_feature_unnester.h"
+#include "gdal_geometry.h"
 #include <gdal.h>
 
 using namespace exactextract;
@@ -253,3 +254,76 @@ TEST_CASE("feature unnest", "[gdal]")
     OGR_FD_Release(nested_defn);
     OGR_FD_Release(unnested_defn);
 }
+
+TEST_CASE("OGR/GEOS geometry conversion", "[gdal]")
+{
+    GEOSContextHandle_t context = initGEOS_r(nullptr, nullptr);
+
+    auto wkt = GENERATE(std::string("POINT (3 8)"),
+                        std::string("POINT EMPTY"),
+                        std::string("LINESTRING (1 1, 2 3, 4 2)"),
+                        std::string("POLYGON EMPTY"),
+                        std::string("POLYGON ((0 0, 10 0, 10 10, 0 10, 0 0), (2 2, 2 3, 3 3, 2 2))"),
+                        std::string("MULTIPOINT ((1 2), (3 4))"),
+                        std::string("MULTILINESTRING ((0 0, 1 1), (2 2, 3 3))"),
+                        std::string("MULTIPOLYGON (((0 0, 1 0, 1 1, 0 0)), ((5 5, 9 5, 9 9, 5 9, 5 5), (6 6, 6 7, 7 7, 6 6)))"),
+                        std::string("GEOMETRYCOLLECTION (POINT (1 1), LINESTRING (0 0, 2 2), POLYGON ((0 0, 1 0, 1 1, 0 0)))"),
+                        std::string("GEOMETRYCOLLECTION EMPTY"));
+
+    CAPTURE(wkt);
+
+    OGRGeometryH ogr_geom = nullptr;
+    char* wkt_ptr = const_cast<char*>(wkt.c_str());
+    REQUIRE(OGR_G_CreateFromWkt(&wkt_ptr, nullptr, &ogr_geom) == OGRERR_NONE);
+
+    auto expected = GEOSGeom_read_r(context, wkt);
+
+    SECTION("OGR to GEOS")
+    {
+        auto direct = ogr_to_geos(context, ogr_geom);
+        auto wkb = ogr_to_geos_wkb(context, ogr_geom);
+
+        CHECK(GEOSEqualsExact_r(context, direct.get(), expected.get(), 0.0));
+        CHECK(GEOSEqualsExact_r(context, wkb.get(), expected.get(), 0.0));
+        CHECK(GEOSGeomTypeId_r(context, direct.get()) == GEOSGeomTypeId_r(context, expected.get()));
+    }
+
+    SECTION("GEOS to OGR")
+    {
+        OGRGeometryH direct = geos_to_ogr(context, expected.get());
+        OGRGeometryH wkb = geos_to_ogr_wkb(context, expected.get());
+
+        CHECK(OGR_G_GetGeometryType(direct) == OGR_G_GetGeometryType(ogr_geom));
+        CHECK(OGR_G_Equals(direct, wkb));
+        CHECK(OGR_G_IsEmpty(direct) == OGR_G_IsEmpty(ogr_geom));
+
+        OGR_G_DestroyGeometry(direct);
+        OGR_G_DestroyGeometry(wkb);
+    }
+
+    OGR_G_DestroyGeometry(ogr_geom);
+    finishGEOS_r(context);
+}
+
+TEST_CASE("OGR/GEOS conversion preserves Z values", "[gdal]")
+{
+    GEOSContextHandle_t context = initGEOS_r(nullptr, nullptr);
+
+    std::string wkt = "POLYGON Z ((0 0 1, 10 0 2, 10 10 3, 0 10 4, 0 0 1))";
+
+    OGRGeometryH ogr_geom = nullptr;
+    char* wkt_ptr = const_cast<char*>(wkt.c_str());
+    REQUIRE(OGR_G_CreateFromWkt(&wkt_ptr, nullptr, &ogr_geom) == OGRERR_NONE);
+
+    auto geos_geom = ogr_to_geos(context, ogr_geom);
+
+    CHECK(GEOSHasZ_r(context, geos_geom.get()));
+
+    const GEOSCoordSequence* seq = GEOSGeom_getCoordSeq_r(context, GEOSGetExteriorRing_r(context, geos_geom.get()));
+    double z;
+    GEOSCoordSeq_getZ_r(context, seq, 2, &z);
+    CHECK(z == 3);
+
+    OGR_G_DestroyGeometry(ogr_geom);
+    finishGEOS_r(context);
+}
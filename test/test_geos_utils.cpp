@@ -48,3 +48,64 @@ TEST_CASE("Segment intersection", "[geos]")
 
     finishGEOS_r(context);
 }
+
+TEST_CASE("Coordinate transformation", "[geos]")
+{
+    GEOSContextHandle_t context = initGEOS_r(nullptr, nullptr);
+
+    auto shift = [](double& x, double& y) {
+        x += 10;
+        y *= 2;
+    };
+
+    auto check_transform = [&](const char* wkt_in, const char* wkt_expected) {
+        auto g = GEOSGeom_read_r(context, wkt_in);
+        auto expected = GEOSGeom_read_r(context, wkt_expected);
+
+        auto transformed = geos_transform_xy(context, g.get(), shift);
+        CHECK(GEOSEqualsExact_r(context, transformed.get(), expected.get(), 1e-12));
+        CHECK(GEOSGeomTypeId_r(context, transformed.get()) == GEOSGeomTypeId_r(context, expected.get()));
+    };
+
+    check_transform("POINT (1 2)", "POINT (11 4)");
+    check_transform("POLYGON ((0 0, 1 0, 1 1, 0 0), (0.5 0.1, 0.9 0.1, 0.9 0.5, 0.5 0.1))",
+                    "POLYGON ((10 0, 11 0, 11 2, 10 0), (10.5 0.2, 10.9 0.2, 10.9 1, 10.5 0.2))");
+    check_transform("MULTIPOLYGON (((0 0, 1 0, 1 1, 0 0)), ((2 2, 3 2, 3 3, 2 2)))",
+                    "MULTIPOLYGON (((10 0, 11 0, 11 2, 10 0)), ((12 4, 13 4, 13 6, 12 4)))");
+    check_transform("GEOMETRYCOLLECTION (POINT (0 0), LINESTRING (1 1, 2 2))",
+                    "GEOMETRYCOLLECTION (POINT (10 0), LINESTRING (11 2, 12 4))");
+    check_transform("POLYGON EMPTY", "POLYGON EMPTY");
+
+    finishGEOS_r(context);
+}
+
+TEST_CASE("Coordinate sequence transformation", "[geos]")
+{
+    GEOSContextHandle_t context = initGEOS_r(nullptr, nullptr);
+
+    std::vector<std::size_t> sizes;
+
+    auto shift = [&sizes](std::size_t n, double* x, double* y) {
+        sizes.push_back(n);
+        for (std::size_t i = 0; i < n; i++) {
+            x[i] += 10;
+            y[i] *= 2;
+        }
+    };
+
+    auto g = GEOSGeom_read_r(context, "MULTIPOLYGON (((0 0, 1 0, 1 1, 0 0), (0.5 0.1, 0.9 0.1, 0.9 0.5, 0.5 0.1)), ((2 2, 3 2, 3 3, 2 3, 2 2)))");
+    auto expected = GEOSGeom_read_r(context, "MULTIPOLYGON (((10 0, 11 0, 11 2, 10 0), (10.5 0.2, 10.9 0.2, 10.9 1, 10.5 0.2)), ((12 4, 13 4, 13 6, 12 6, 12 4)))");
+
+    auto transformed = geos_transform_seq(context, g.get(), shift);
+    CHECK(GEOSEqualsExact_r(context, transformed.get(), expected.get(), 1e-12));
+
+    // each ring is transformed with a single call
+    CHECK(sizes == std::vector<std::size_t>{ 4, 4, 5 });
+
+    sizes.clear();
+    auto empty = GEOSGeom_read_r(context, "POLYGON EMPTY");
+    CHECK(GEOSisEmpty_r(context, geos_transform_seq(context, empty.get(), shift).get()));
+    CHECK(sizes.empty());
+
+    finishGEOS_r(context);
+}
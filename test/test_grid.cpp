@@ -1,5 +1,6 @@
 #include "catch.hpp"
 
+#include "affine_transform.h"
 #include "grid.h"
 
 #include <numeric>
@@ -383,9 +384,95 @@ TEST_CASE("Grid subdivision", "[grid]")
     CHECK(total_subgrid_size(grids) == g.size());
 }
 
+TEST_CASE("Block-aligned grid subdivision", "[grid]")
+{
+    SECTION("strips")
+    {
+        // 100x100 grid stored in blocks of 16 rows
+        Grid<bounded_extent> g{ { 0, 0, 100, 100 }, 1, 1 };
+
+        // 20 rows fit into each subgrid, but only 16 are used so that blocks are not split
+        auto grids = subdivide(g, 2000, 16, 100, 0, 0);
+
+        CHECK(grids.size() == 7);
+        CHECK(grids[0].rows() == 16);
+        CHECK(grids[6].rows() == 4);
+        CHECK(total_subgrid_size(grids) == g.size());
+
+        // If our grid starts 8 rows into a block, the first subgrid only covers the remainder of that block
+        grids = subdivide(g, 2000, 16, 100, 8, 0);
+
+        CHECK(grids.size() == 7);
+        CHECK(grids[0].rows() == 8);
+        CHECK(grids[1].rows() == 16);
+        CHECK(grids[6].rows() == 12);
+        CHECK(total_subgrid_size(grids) == g.size());
+    }
+
+    SECTION("tiles")
+    {
+        // 1000x1000 grid stored in 256x256 tiles
+        Grid<bounded_extent> g{ { 0, 0, 1000, 1000 }, 1, 1 };
+
+        auto grids = subdivide(g, 600, 256, 256, 0, 0);
+
+        CHECK(grids.size() == 2 * g.rows());
+        CHECK(grids[0].cols() == 512);
+        CHECK(grids[1].cols() == 488);
+        CHECK(total_subgrid_size(grids) == g.size());
+    }
+
+    SECTION("blocks larger than maximum subgrid size")
+    {
+        Grid<bounded_extent> g{ { -180, -89.75, 180, 90 }, 0.25, 0.25 };
+
+        CHECK(subdivide(g, 1000, 2048, 2048, 0, 0).size() == subdivide(g, 1000).size());
+    }
+}
+
 TEST_CASE("Empty grid subdivision", "[grid]")
 {
     auto g = Grid<bounded_extent>::make_empty();
 
     auto grids = subdivide(g, 100);
 }
+
+TEST_CASE("Affine transform maps pixel-space grid to raster coordinates", "[grid]")
+{
+    // 3x2 raster rotated 90 degrees: columns increase to the north, rows to the east
+    double gt[6] = { 10, 0, 2, 20, 4, 0 };
+    auto transform = AffineTransform::from_geotransform(gt, 2);
+
+    // upper-left corner of the raster is the upper-left corner of the pixel-space grid
+    CHECK(transform.apply(0, 2) == Coordinate{ 10, 20 });
+    // lower-left corner of the pixel-space grid is after the last row
+    CHECK(transform.apply(0, 0) == Coordinate{ 14, 20 });
+    // upper-right corner is after the last column
+    CHECK(transform.apply(3, 2) == Coordinate{ 10, 32 });
+
+    auto inv = transform.inverse();
+    for (const auto& c : { Coordinate{ 0, 0 }, Coordinate{ 1.5, 0.5 }, Coordinate{ 3, 2 } }) {
+        auto xy = transform.apply(c.x, c.y);
+        auto uv = inv.apply(xy.x, xy.y);
+
+        CHECK(uv.x == Approx(c.x));
+        CHECK(uv.y == Approx(c.y));
+    }
+}
+
+TEST_CASE("Affine transform of a north-up raster is a translation and scaling", "[grid]")
+{
+    double gt[6] = { -180, 0.5, 0, 90, 0, -0.5 };
+    auto transform = AffineTransform::from_geotransform(gt, 360);
+
+    CHECK(transform.coefficients() == std::array<double, 6>{ -180, 0.5, 0, -90, 0, 0.5 });
+    CHECK(transform.apply(720, 360) == Coordinate{ 180, 90 });
+}
+
+TEST_CASE("Degenerate affine transform cannot be inverted", "[grid]")
+{
+    AffineTransform transform({ 0, 1, 2, 0, 2, 4 });
+
+    CHECK(transform.determinant() == 0);
+    CHECK_THROWS_WITH(transform.inverse(), Catch::Contains("not invertible"));
+}
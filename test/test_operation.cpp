@@ -6,10 +6,16 @@
 #include "memory_raster_source.h"
 #include "operation.h"
 #include "output_writer.h"
+#include "processing_plan.h"
+#include "processing_profile.h"
+#include "progress_event.h"
 #include "raster.h"
 #include "raster_sequential_processor.h"
 #include "raster_source.h"
 
+#include <numeric>
+#include <optional>
+
 using namespace exactextract;
 
 class WKTFeatureSource : public FeatureSource
@@ -20,7 +26,7 @@ class WKTFeatureSource : public FeatureSource
     {
     }
 
-    void reset()
+    void reset() override
     {
         m_pos = 0;
     }
@@ -66,6 +72,28 @@ class TestWriter : public OutputWriter
     MapFeature m_feature;
 };
 
+class VectorWriter : public OutputWriter
+{
+  public:
+    explicit VectorWriter(std::vector<MapFeature>& features)
+      : m_features(features)
+    {
+    }
+
+    std::unique_ptr<Feature> create_feature() override
+    {
+        return std::make_unique<MapFeature>();
+    }
+
+    void write(const Feature& f) override
+    {
+        m_features.emplace_back(f);
+    }
+
+  private:
+    std::vector<MapFeature>& m_features;
+};
+
 static GEOSContextHandle_t
 init_geos()
 {
@@ -117,6 +145,86 @@ TEST_CASE("Operations dispatch to the correct RasterStats function", "[operation
     CHECK(f.get_double(stat) == Approx(expected));
 }
 
+TEST_CASE("Approximate median is close to exact median", "[operation]")
+{
+    GEOSContextHandle_t context = init_geos();
+
+    Grid<bounded_extent> ex{ { 0, 0, 100, 100 }, 1, 1 };
+    auto value_rast = std::make_unique<Raster<double>>(ex);
+    for (std::size_t i = 0; i < ex.rows(); i++) {
+        for (std::size_t j = 0; j < ex.cols(); j++) {
+            (*value_rast)(i, j) = static_cast<double>((i * 37 + j * 101) % 1000);
+        }
+    }
+    MemoryRasterSource value_src(std::move(value_rast));
+
+    WKTFeatureSource ds;
+    MapFeature mf;
+    mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((0.5 0.5, 99.5 0.5, 99.5 99.5, 0.5 99.5, 0.5 0.5))")));
+    ds.add_feature(std::move(mf));
+
+    TestWriter writer;
+
+    FeatureSequentialProcessor fsp(ds, writer);
+    auto exact = Operation::create("median", "exact", &value_src, nullptr);
+    auto approx = Operation::create("median", "approx", &value_src, nullptr, { { "approx", "true" } });
+    fsp.add_operation(*exact);
+    fsp.add_operation(*approx);
+    fsp.set_max_cells_in_memory(1000);
+
+    fsp.process();
+
+    const MapFeature& f = writer.m_feature;
+
+    CHECK(f.get_double("approx") == Approx(f.get_double("exact")).margin(5));
+}
+
+TEMPLATE_TEST_CASE("Histogram reports coverage of values in each bin", "[operation]", FeatureSequentialProcessor, RasterSequentialProcessor)
+{
+    GEOSContextHandle_t context = init_geos();
+
+    Grid<bounded_extent> ex{ { 0, 0, 3, 3 }, 1, 1 }; // 3x3 grid
+    Matrix<double> values{ { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 } } };
+    auto value_rast = std::make_unique<Raster<double>>(std::move(values), ex.extent());
+    MemoryRasterSource value_src(std::move(value_rast));
+
+    Matrix<double> weights{ { { 2, 2, 2 }, { 2, 2, 2 }, { 2, 2, 2 } } };
+    auto weight_rast = std::make_unique<Raster<double>>(std::move(weights), ex.extent());
+    MemoryRasterSource weight_src(std::move(weight_rast));
+
+    WKTFeatureSource ds;
+    MapFeature mf;
+    mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((0.5 0.5, 2.5 0.5, 2.5 2.5, 0.5 2.5, 0.5 0.5))")));
+    ds.add_feature(std::move(mf));
+
+    TestWriter writer;
+
+    TestType processor(ds, writer);
+    auto edges = Operation::create("histogram", "edges", &value_src, nullptr, { { "edges", "0:4:8:10" } });
+    auto fixed = Operation::create("histogram", "fixed", &value_src, nullptr, { { "bins", "3" }, { "min", "1" }, { "max", "10" } });
+    auto weighted = Operation::create("weighted_histogram", "weighted", &value_src, &weight_src, { { "edges", "0:4:8:10" } });
+    auto outside = Operation::create("histogram", "outside", &value_src, nullptr, { { "edges", "20:30" } });
+    processor.add_operation(*edges);
+    processor.add_operation(*fixed);
+    processor.add_operation(*weighted);
+    processor.add_operation(*outside);
+
+    CHECK(edges->key() != fixed->key());
+
+    processor.process();
+
+    const MapFeature& f = writer.m_feature;
+
+    auto to_vector = [](const Feature::DoubleArray& arr) {
+        return std::vector<double>(arr.data, arr.data + arr.size);
+    };
+
+    CHECK(to_vector(f.get_double_array("edges")) == std::vector<double>{ 1.0, 2.25, 0.75 });
+    CHECK(to_vector(f.get_double_array("fixed")) == std::vector<double>{ 1.0, 2.0, 1.0 });
+    CHECK(to_vector(f.get_double_array("weighted")) == std::vector<double>{ 2.0, 4.5, 1.5 });
+    CHECK(to_vector(f.get_double_array("outside")) == std::vector<double>{ 0.0 });
+}
+
 TEMPLATE_TEST_CASE("result_type returns correct result", "[operation]", double, float, std::int8_t, std::uint8_t, std::int16_t, std::uint16_t, std::int32_t, std::uint32_t, std::int64_t, std::uint64_t)
 {
     GEOSContextHandle_t context = init_geos();
@@ -294,6 +402,76 @@ TEMPLATE_TEST_CASE("no error if feature does not intersect raster", "[processor]
     CHECK_THROWS(f.get_double("median"));
 }
 
+TEMPLATE_TEST_CASE("features outside of the rasters can be omitted", "[processor]", FeatureSequentialProcessor, RasterSequentialProcessor)
+{
+    GEOSContextHandle_t context = init_geos();
+
+    class FilteredFeatureSource : public WKTFeatureSource
+    {
+      public:
+        void set_spatial_filter(const Box& box) override
+        {
+            filter = box;
+        }
+
+        std::optional<Box> filter;
+    };
+
+    Grid<bounded_extent> ex{ { 0, 0, 3, 3 }, 1, 1 }; // 3x3 grid
+    Matrix<double> values{ { { 1, 1, 1 },
+                             { 2, 2, 2 },
+                             { 3, 3, 3 } } };
+
+    auto value_rast = std::make_unique<Raster<double>>(std::move(values), ex.extent());
+    MemoryRasterSource value_src(std::move(value_rast));
+
+    FilteredFeatureSource ds;
+    MapFeature mf1;
+    mf1.set("fid", "1");
+    mf1.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((0 0, 3 0, 3 3, 0 0))")));
+    ds.add_feature(std::move(mf1));
+    MapFeature mf2;
+    mf2.set("fid", "2");
+    mf2.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((10 10, 11 10, 11 11, 10 11, 10 10))")));
+    ds.add_feature(std::move(mf2));
+    MapFeature mf3;
+    mf3.set("fid", "3");
+    ds.add_feature(std::move(mf3));
+
+    std::vector<MapFeature> written;
+    VectorWriter writer(written);
+
+    TestType processor(ds, writer);
+    processor.include_col("fid");
+    auto count = Operation::create("count", "count", &value_src, nullptr);
+    processor.add_operation(*count);
+
+    SECTION("features outside of the rasters are written with empty statistics by default")
+    {
+        processor.process();
+
+        CHECK(!ds.filter.has_value());
+
+        REQUIRE(written.size() == 3);
+        for (const auto& f : written) {
+            CHECK(f.get_double("count") == (f.get_string("fid") == "1" ? 4.5 : 0));
+        }
+    }
+
+    SECTION("features outside of the rasters are omitted and the extent is used as a spatial filter")
+    {
+        processor.set_omit_features_outside(true);
+        processor.process();
+
+        REQUIRE(ds.filter.has_value());
+        CHECK(*ds.filter == ex.extent());
+
+        REQUIRE(written.size() == 1);
+        CHECK(written[0].get_string("fid") == "1");
+        CHECK(written[0].get_double("count") == 4.5);
+    }
+}
+
 TEST_CASE("progress callback is called once for each feature", "[processor]")
 {
     GEOSContextHandle_t context = init_geos();
@@ -367,7 +545,76 @@ TEST_CASE("progress callback is called once for each feature", "[processor]")
     }
 }
 
-TEMPLATE_TEST_CASE("correct result for feature partially intersecting raster", "[processor]", FeatureSequentialProcessor, RasterSequentialProcessor)
+TEMPLATE_TEST_CASE("progress events report rate of processing", "[processor]", FeatureSequentialProcessor, RasterSequentialProcessor)
+{
+    GEOSContextHandle_t context = init_geos();
+
+    Grid<bounded_extent> ex{ { 0, 0, 3, 3 }, 1, 1 }; // 3x3 grid
+    Matrix<double> values{ { { 9, 1, 1 },
+                             { 2, 2, 2 },
+                             { 3, 3, 3 } } };
+
+    auto value_rast = std::make_unique<Raster<double>>(std::move(values), ex.extent());
+    MemoryRasterSource value_src(std::move(value_rast));
+
+    WKTFeatureSource ds;
+    for (int i = 0; i < 3; i++) {
+        MapFeature mf;
+        mf.set("fid", i);
+        mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((0 0, 3 0, 3 3, 0 0))")));
+        ds.add_feature(std::move(mf));
+    }
+
+    std::vector<ProgressEvent> events;
+
+    TestWriter writer;
+    auto count = Operation::create("count", "count", &value_src, nullptr);
+
+    TestType processor(ds, writer);
+    processor.set_progress_fn([&events](const ProgressEvent& event) {
+        events.push_back(event);
+    });
+    processor.set_max_cells_in_memory(3);
+    processor.add_operation(*count);
+
+    SECTION("no events unless progress is enabled")
+    {
+        processor.process();
+
+        CHECK(events.empty());
+    }
+
+    SECTION("events are reported when progress is enabled")
+    {
+        processor.show_progress(true);
+        processor.process();
+
+        REQUIRE(events.size() == 3);
+
+        for (std::size_t i = 1; i < events.size(); i++) {
+            CHECK(events[i].fraction > events[i - 1].fraction);
+            CHECK(events[i].features >= events[i - 1].features);
+            CHECK(events[i].cells_read >= events[i - 1].cells_read);
+            CHECK(events[i].elapsed >= events[i - 1].elapsed);
+        }
+
+        const auto& last = events.back();
+        CHECK(last.fraction == 1);
+        CHECK(last.cells_read > 0);
+        CHECK(last.bytes_read == last.cells_read * sizeof(double));
+        CHECK(last.remaining() == 0.0);
+
+        ProgressEvent halfway;
+        halfway.fraction = 0.25;
+        halfway.features = 10;
+        halfway.elapsed = 2;
+        CHECK(halfway.features_per_second() == 5);
+        CHECK(halfway.remaining() == 6.0);
+        CHECK_FALSE(ProgressEvent().remaining().has_value());
+    }
+}
+
+TEST_CASE("RasterSequentialProcessor writes features once the sweep has passed them", "[processor]")
 {
     GEOSContextHandle_t context = init_geos();
 
@@ -379,26 +626,62 @@ TEMPLATE_TEST_CASE("correct result for feature partially intersecting raster", "
     MemoryRasterSource value_src(std::move(value_rast));
 
     WKTFeatureSource ds;
-    MapFeature mf;
-    mf.set("fid", "15");
-    mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((2 2, 100 2, 100 100, 2 100, 2 2))")));
-    ds.add_feature(std::move(mf));
+    {
+        MapFeature mf;
+        mf.set("fid", "bottom");
+        mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((0.5 0.1, 2.5 0.1, 2.5 0.5, 0.5 0.5, 0.5 0.1))")));
+        ds.add_feature(std::move(mf));
+    }
+    {
+        MapFeature mf;
+        mf.set("fid", "top");
+        mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((0.5 2.5, 2.5 2.5, 2.5 2.9, 0.5 2.9, 0.5 2.5))")));
+        ds.add_feature(std::move(mf));
+    }
 
-    TestWriter writer;
+    std::vector<std::string> events;
+
+    class LoggingWriter : public OutputWriter
+    {
+      public:
+        explicit LoggingWriter(std::vector<std::string>& events)
+          : m_events(events)
+        {
+        }
+
+        std::unique_ptr<Feature> create_feature() override
+        {
+            return std::make_unique<MapFeature>();
+        }
+
+        void write(const Feature& f) override
+        {
+            m_events.push_back(f.get_string("fid"));
+        }
+
+      private:
+        std::vector<std::string>& m_events;
+    };
+
+    LoggingWriter writer(events);
+
+    RasterSequentialProcessor processor(ds, writer);
+    processor.set_max_cells_in_memory(3);
+    processor.show_progress(true);
+    processor.set_progress_fn([&events](double, std::string_view) {
+        events.push_back("progress");
+    });
 
-    TestType processor(ds, writer);
     auto count = Operation::create("count", "count", &value_src, nullptr);
-    auto median = Operation::create("median", "median", &value_src, nullptr);
+    processor.include_col("fid");
     processor.add_operation(*count);
-    processor.add_operation(*median);
     processor.process();
 
-    const MapFeature& f = writer.m_feature;
-    CHECK(f.get_double("count") == 1);
-    CHECK(f.get_double("median") == 3);
+    std::vector<std::string> expected{ "top", "progress", "progress", "bottom", "progress" };
+    CHECK(events == expected);
 }
 
-TEMPLATE_TEST_CASE("include_col and include_geom work as expected", "[processor]", FeatureSequentialProcessor, RasterSequentialProcessor)
+TEMPLATE_TEST_CASE("per-cell operations can be written in chunks", "[processor]", FeatureSequentialProcessor, RasterSequentialProcessor)
 {
     GEOSContextHandle_t context = init_geos();
 
@@ -411,74 +694,950 @@ TEMPLATE_TEST_CASE("include_col and include_geom work as expected", "[processor]
 
     WKTFeatureSource ds;
     MapFeature mf;
-    mf.set("fid", "15");
-    mf.set("type", 13);
-    mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((0 0, 2 0, 2 2, 0 2, 0 0))")));
+    mf.set("fid", "a");
+    mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((0 0, 3 0, 3 3, 0 3, 0 0))")));
     ds.add_feature(std::move(mf));
 
-    TestWriter writer;
+    MapFeature outside;
+    outside.set("fid", "outside");
+    outside.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((10 10, 11 10, 11 11, 10 11, 10 10))")));
+    ds.add_feature(std::move(outside));
+
+    class CollectingWriter : public OutputWriter
+    {
+      public:
+        std::unique_ptr<Feature> create_feature() override
+        {
+            return std::make_unique<MapFeature>();
+        }
+
+        void write(const Feature& f) override
+        {
+            m_features.emplace_back(f);
+        }
+
+        std::vector<MapFeature> m_features;
+    };
+
+    CollectingWriter writer;
 
     TestType processor(ds, writer);
-    auto count = Operation::create("count", "count", &value_src, nullptr);
-    processor.add_operation(*count);
+    processor.set_max_cells_in_memory(3);
+    processor.set_stream_cells(true);
+
+    auto vals = Operation::create("values", "values", &value_src, nullptr);
+    auto cov = Operation::create("coverage", "coverage", &value_src, nullptr);
+    auto mean = Operation::create("mean", "mean", &value_src, nullptr);
+
+    CHECK_THROWS_WITH(processor.add_operation(*mean), Catch::Contains("cannot be used when streaming"));
+
     processor.include_col("fid");
-    processor.include_col("type");
-    processor.include_geometry();
+    processor.add_operation(*vals);
+    processor.add_operation(*cov);
     processor.process();
 
-    ds.reset();
-    ds.next();
+    REQUIRE(writer.m_features.size() == 4);
 
-    const MapFeature& f = writer.m_feature;
-    CHECK(f.get_double("count") == 4.0);
-    CHECK(f.get_string("fid") == "15");
-    CHECK(f.get_int("type") == 13);
-    CHECK(GEOSEquals_r(context, f.geometry(), ds.feature().geometry()) == 1);
+    std::vector<double> all_values;
+    for (const auto& f : writer.m_features) {
+        if (f.get_string("fid") == "outside") {
+            // written once, with empty results
+            CHECK(f.get_double_array("values").size == 0);
+            continue;
+        }
+
+        CHECK(f.get_string("fid") == "a");
+
+        auto v = f.get_double_array("values");
+        auto c = f.get_double_array("coverage");
+        CHECK(v.size == 3);
+        CHECK(c.size == 3);
+
+        all_values.insert(all_values.end(), v.data, v.data + v.size);
+    }
+
+    std::sort(all_values.begin(), all_values.end());
+    CHECK(all_values == std::vector<double>{ 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+
+    CHECK(std::count_if(writer.m_features.begin(), writer.m_features.end(), [](const MapFeature& f) {
+              return f.get_string("fid") == "outside";
+          }) == 1);
 }
 
-TEST_CASE("Operation arguments", "[operation]")
+TEMPLATE_TEST_CASE("batched operations receive results for several features at once", "[processor]", FeatureSequentialProcessor, RasterSequentialProcessor)
 {
-    MemoryRasterSource mrs{ std::make_unique<Raster<float>>(Raster<float>::make_empty()) };
+    GEOSContextHandle_t context = init_geos();
 
-    SECTION("successful arg parsing")
+    // Computes the sum of each feature, recording the number of features in each batch
+    class BatchedSum : public Operation
     {
-        Operation::ArgMap args{ { "q", "0.05" } };
+      public:
+        BatchedSum(RasterSource* p_values, std::size_t batch_size, std::shared_ptr<std::vector<std::size_t>> batches, ArgMap args = {})
+          : Operation("sum", "batched_sum", p_values, nullptr, args)
+          , m_batch_size(batch_size)
+          , m_batches(batches)
+        {
+        }
 
-        auto op = Operation::create("quantile", "fizz", &mrs, nullptr, args);
-        CHECK(op->name == "fizz_5");
+        std::unique_ptr<Operation> clone() const override
+        {
+            return std::make_unique<BatchedSum>(*this);
+        }
 
-        // args are not modified
-        CHECK(args.find("q") != args.end());
-    }
+        Feature::ValueType result_type() const override
+        {
+            return Feature::ValueType::DOUBLE;
+        }
 
-    SECTION("error if not all args are consumed")
-    {
-        Operation::ArgMap args{ { "q", "0.05" }, { "qq", "0.15" } };
-        CHECK_THROWS_WITH(Operation::create("quantile", "quantile", &mrs, nullptr, args), Catch::StartsWith("Unexpected argument"));
+        void set_result(const StatsRegistry::RasterStatsVariant&, Feature&) const override
+        {
+            throw std::runtime_error("Results should only be assigned in batches.");
+        }
 
-        // args are not modified
-        CHECK(args.find("q") != args.end());
-        CHECK(args.find("qq") != args.end());
-    }
+        std::size_t batch_size() const override
+        {
+            return m_batch_size;
+        }
 
-    SECTION("error if arg cannot be parsed")
-    {
-        Operation::ArgMap args{ { "q", "chicken" } };
-        CHECK_THROWS_WITH(Operation::create("quantile", "quantile", &mrs, nullptr, args), Catch::StartsWith("Failed to parse"));
-    }
+        void add_to_batch(const StatsRegistry::RasterStatsVariant& stats) const override
+        {
+            m_sums.push_back(std::visit([](const auto& s) { return s.sum(); }, stats));
+        }
 
-    SECTION("error if arg is invalid")
+        void set_batch_results(const std::vector<Feature*>& f_out) const override
+        {
+            REQUIRE(f_out.size() == m_sums.size());
+            for (std::size_t i = 0; i < f_out.size(); i++) {
+                f_out[i]->set(name, m_sums[i]);
+            }
+            m_batches->push_back(m_sums.size());
+            m_sums.clear();
+        }
+
+      private:
+        std::size_t m_batch_size;
+        std::shared_ptr<std::vector<std::size_t>> m_batches;
+        mutable std::vector<double> m_sums;
+    };
+
+    class CollectingWriter : public OutputWriter
     {
-        Operation::ArgMap args{ { "q", "5" } };
-        CHECK_THROWS_WITH(Operation::create("quantile", "quantile", &mrs, nullptr, args), Catch::Contains("must be between 0 and 1"));
+      public:
+        std::unique_ptr<Feature> create_feature() override
+        {
+            return std::make_unique<MapFeature>();
+        }
+
+        void write(const Feature& f) override
+        {
+            m_features.emplace_back(f);
+        }
+
+        std::vector<MapFeature> m_features;
+    };
+
+    Grid<bounded_extent> ex{ { 0, 0, 5, 1 }, 1, 1 }; // 1x5 grid
+    Matrix<double> values{ { { 1, 2, 3, 4, 5 } } };
+    auto value_rast = std::make_unique<Raster<double>>(std::move(values), ex.extent());
+    MemoryRasterSource value_src(std::move(value_rast));
+
+    WKTFeatureSource ds;
+    for (int i = 0; i < 5; i++) {
+        MapFeature mf;
+        mf.set("fid", std::to_string(i));
+        std::string wkt = "POLYGON ((" + std::to_string(i) + " 0, " + std::to_string(i + 1) + " 0, " + std::to_string(i + 1) + " 1, " + std::to_string(i) + " 1, " + std::to_string(i) + " 0))";
+        mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, wkt.c_str())));
+        ds.add_feature(std::move(mf));
     }
 
-    SECTION("error if required arg is missing")
+    CollectingWriter writer;
+    TestType processor(ds, writer);
+
+    auto batches = std::make_shared<std::vector<std::size_t>>();
+    BatchedSum batched_sum(&value_src, 2, batches);
+    auto sum = Operation::create("sum", "sum", &value_src, nullptr);
+
+    processor.include_col("fid");
+    processor.add_operation(batched_sum);
+    processor.add_operation(*sum);
+    processor.process();
+
+    CHECK(*batches == std::vector<std::size_t>{ 2, 2, 1 });
+
+    REQUIRE(writer.m_features.size() == 5);
+    for (const auto& f : writer.m_features) {
+        CHECK(f.get_double("batched_sum") == f.get_double("sum"));
+        CHECK(f.get_double("sum") == std::stod(f.get_string("fid")) + 1);
+    }
+}
+
+TEMPLATE_TEST_CASE("features can be processed after the processing plan is explained", "[processor]", FeatureSequentialProcessor, RasterSequentialProcessor)
+{
+    GEOSContextHandle_t context = init_geos();
+
+    Grid<bounded_extent> ex{ { 0, 0, 3, 3 }, 1, 1 }; // 3x3 grid
+    Matrix<double> values{ { { 1, 1, 1 },
+                             { 2, 2, 2 },
+                             { 3, 3, 3 } } };
+
+    auto value_rast = std::make_unique<Raster<double>>(std::move(values), ex.extent());
+    MemoryRasterSource value_src(std::move(value_rast));
+
+    WKTFeatureSource ds;
+    for (int i = 0; i < 3; i++) {
+        MapFeature mf;
+        mf.set("fid", i);
+        mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((0 0, 3 0, 3 3, 0 0))")));
+        ds.add_feature(std::move(mf));
+    }
+
+    std::vector<MapFeature> written;
+    VectorWriter writer(written);
+
+    TestType processor(ds, writer);
+    auto count = Operation::create("count", "count", &value_src, nullptr);
+    processor.add_operation(*count);
+
+    std::stringstream ss;
+    processor.explain(ss);
+    CHECK_THAT(ss.str(), Catch::Contains("Features: 3"));
+    CHECK(written.empty());
+
+    processor.process();
+
+    REQUIRE(written.size() == 3);
+    for (const auto& f : written) {
+        CHECK(f.get_double("count") == 4.5);
+    }
+}
+
+TEMPLATE_TEST_CASE("Processor records a profile of its work", "[processor]", FeatureSequentialProcessor, RasterSequentialProcessor)
+{
+    GEOSContextHandle_t context = init_geos();
+
+    Grid<bounded_extent> ex{ { 0, 0, 3, 3 }, 1, 1 }; // 3x3 grid
+    Matrix<double> values{ { { 1, 2, 3 },
+                             { 4, 5, 6 },
+                             { 7, 8, 9 } } };
+    auto value_rast = std::make_unique<Raster<double>>(std::move(values), ex.extent());
+    MemoryRasterSource value_src(std::move(value_rast));
+
+    WKTFeatureSource ds;
+    {
+        MapFeature mf;
+        mf.set("fid", "a");
+        mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((0 0, 3 0, 3 3, 0 3, 0 0))")));
+        ds.add_feature(std::move(mf));
+    }
+    {
+        MapFeature mf;
+        mf.set("fid", "b");
+        mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((10 10, 11 10, 11 11, 10 10))")));
+        ds.add_feature(std::move(mf));
+    }
+
+    TestWriter writer;
+
+    TestType processor(ds, writer);
+    auto mean = Operation::create("mean", "mean", &value_src, nullptr);
+    processor.add_operation(*mean);
+
+    using Phase = ProcessingProfile::Phase;
+
+    SECTION("nothing is recorded by default")
+    {
+        processor.process();
+
+        const auto& profile = processor.profile();
+        CHECK(profile.features() == 0);
+        CHECK(profile.cells_read() == 0);
+        CHECK(profile.wall_seconds(Phase::TOTAL) == 0);
+    }
+
+    SECTION("profile is recorded when enabled")
+    {
+        processor.collect_profile(true);
+        processor.process();
+
+        const auto& profile = processor.profile();
+        CHECK(profile.features() == 2);
+        CHECK(profile.features_skipped() == 1);
+        CHECK(profile.cells_read() == 9);
+        CHECK(profile.bytes_read() == 9 * sizeof(double));
+        CHECK(profile.cells_covered() == 9);
+
+        double phase_total = 0;
+        for (auto phase : { Phase::READ_FEATURES, Phase::READ_RASTERS, Phase::COVERAGE, Phase::STATS, Phase::WRITE }) {
+            CHECK(profile.wall_seconds(phase) >= 0);
+            CHECK(profile.cpu_seconds(phase) >= 0);
+            phase_total += profile.wall_seconds(phase);
+        }
+        CHECK(profile.wall_seconds(Phase::TOTAL) >= phase_total);
+
+        std::stringstream ss;
+        profile.write_json(ss);
+        CHECK_THAT(ss.str(), Catch::Contains("\"cells_read\": 9") && Catch::Contains("\"features_skipped\": 1"));
+    }
+}
+
+TEST_CASE("ProcessingPlan groups operations sharing a RasterStats", "[processor]")
+{
+    Grid<bounded_extent> ex{ { 0, 0, 3, 3 }, 1, 1 }; // 3x3 grid
+    Matrix<double> values{ { { 1, 2, 3 },
+                             { 4, 5, 6 },
+                             { 7, 8, 9 } } };
+    Matrix<float> weights{ { { 1, 1, 1 },
+                             { 1, 1, 1 },
+                             { 1, 1, 1 } } };
+
+    MemoryRasterSource value_src(std::make_unique<Raster<double>>(std::move(values), ex.extent()));
+    value_src.set_name("value");
+    MemoryRasterSource weight_src(std::make_unique<Raster<float>>(std::move(weights), ex.extent()));
+    weight_src.set_name("weight");
+
+    std::vector<std::unique_ptr<Operation>> ops;
+    ops.push_back(Operation::create("mean", "mean", &value_src, nullptr));
+    ops.push_back(Operation::create("median", "median", &value_src, nullptr));
+    ops.push_back(Operation::create("weighted_mean", "weighted_mean", &value_src, &weight_src));
+
+    StatsRegistry reg;
+    for (const auto& op : ops) {
+        reg.prepare(*op);
+    }
+
+    ProcessingPlan plan(ops, reg, DEFAULT_GRID_COMPAT_TOL);
+
+    CHECK(plan.grid() == ex);
+    CHECK(plan.rasters() == std::vector<RasterSource*>{ &value_src, &weight_src });
+    CHECK(plan.stats_operations() == std::vector<const Operation*>{ ops[0].get(), ops[2].get() });
+
+    // histogram is only stored for the RasterStats used by median
+    CHECK(reg.options(*ops[1]).store_histogram);
+    CHECK(!reg.options(*ops[2]).store_histogram);
+
+    plan.schedule_read({ 0, 0, 2, 2 });
+    plan.schedule_read({ 10, 10, 20, 20 });
+
+    CHECK(plan.cells_read(value_src) == 4);
+    CHECK(plan.bytes_read(value_src) == 4 * sizeof(double));
+    CHECK(plan.bytes_read(weight_src) == 4 * sizeof(float));
+
+    std::stringstream ss;
+    plan.explain(ss);
+
+    CHECK(ss.str().find("mean, median: values value; stores histogram") != std::string::npos);
+    CHECK(ss.str().find("weighted_mean: values value, weights weight") != std::string::npos);
+}
+
+TEST_CASE("StatsRegistry computes cell areas for the grid of a plan", "[processor]")
+{
+    Grid<bounded_extent> ex{ { 0, 40, 3, 43 }, 1, 1 }; // 3x3 grid
+    MemoryRasterSource value_src(std::make_unique<Raster<double>>(Matrix<double>{ 3, 3, 1.0 }, ex.extent()));
+
+    auto spherical = Operation::create("sum", "spherical", &value_src, nullptr, { { "coverage_weight", "area_spherical_km2" } });
+    auto cartesian = Operation::create("sum", "cartesian", &value_src, nullptr, { { "coverage_weight", "area_cartesian" } });
+
+    StatsRegistry reg;
+    reg.prepare(*spherical);
+    reg.prepare(*cartesian);
+
+    reg.prepare_cell_areas(*spherical, ex);
+    reg.prepare_cell_areas(*cartesian, ex);
+
+    const auto& cell_areas = reg.options(*spherical).cell_areas;
+    REQUIRE(cell_areas != nullptr);
+    CHECK(cell_areas->shape() == LatitudeBandAreas::Shape::SPHERE);
+    CHECK(cell_areas->row_offset(ex.crop({ 0, 40, 3, 42 })) == 1u);
+
+    CHECK(reg.options(*cartesian).cell_areas == nullptr);
+}
+
+TEMPLATE_TEST_CASE("correct result for feature partially intersecting raster", "[processor]", FeatureSequentialProcessor, RasterSequentialProcessor)
+{
+    GEOSContextHandle_t context = init_geos();
+
+    Grid<bounded_extent> ex{ { 0, 0, 3, 3 }, 1, 1 }; // 3x3 grid
+    Matrix<double> values{ { { 1, 2, 3 },
+                             { 4, 5, 6 },
+                             { 7, 8, 9 } } };
+    auto value_rast = std::make_unique<Raster<double>>(std::move(values), ex.extent());
+    MemoryRasterSource value_src(std::move(value_rast));
+
+    WKTFeatureSource ds;
+    MapFeature mf;
+    mf.set("fid", "15");
+    mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((2 2, 100 2, 100 100, 2 100, 2 2))")));
+    ds.add_feature(std::move(mf));
+
+    TestWriter writer;
+
+    TestType processor(ds, writer);
+    auto count = Operation::create("count", "count", &value_src, nullptr);
+    auto median = Operation::create("median", "median", &value_src, nullptr);
+    processor.add_operation(*count);
+    processor.add_operation(*median);
+    processor.process();
+
+    const MapFeature& f = writer.m_feature;
+    CHECK(f.get_double("count") == 1);
+    CHECK(f.get_double("median") == 3);
+}
+
+TEMPLATE_TEST_CASE("unweighted operations on a coarse raster use coverage of its own cells", "[processor]", FeatureSequentialProcessor, RasterSequentialProcessor)
+{
+    GEOSContextHandle_t context = init_geos();
+
+    Box extent{ 0, 0, 4, 4 };
+
+    Matrix<double> values{ { { 1, 2 },
+                             { 3, 4 } } };
+    auto value_rast = std::make_unique<Raster<double>>(std::move(values), extent);
+    MemoryRasterSource value_src(std::move(value_rast));
+
+    auto weight_rast = std::make_unique<Raster<double>>(Matrix<double>{ 4, 4, 1.0 }, extent);
+    MemoryRasterSource weight_src(std::move(weight_rast));
+
+    WKTFeatureSource ds;
+    MapFeature mf;
+    mf.set("fid", "1");
+    // covers one quarter of each cell of the value raster
+    mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((1 1, 3 1, 3 3, 1 3, 1 1))")));
+    ds.add_feature(std::move(mf));
+
+    TestWriter writer;
+
+    TestType processor(ds, writer);
+    auto count = Operation::create("count", "count", &value_src, nullptr);
+    auto sum = Operation::create("sum", "sum", &value_src, nullptr);
+    auto vals = Operation::create("values", "values", &value_src, nullptr);
+    auto cov = Operation::create("coverage", "coverage", &value_src, nullptr);
+    auto weighted_sum = Operation::create("weighted_sum", "weighted_sum", &value_src, &weight_src);
+    processor.add_operation(*count);
+    processor.add_operation(*sum);
+    processor.add_operation(*vals);
+    processor.add_operation(*cov);
+    processor.add_operation(*weighted_sum);
+    processor.process();
+
+    const MapFeature& f = writer.m_feature;
+
+    // same results as if the value raster were processed alone
+    CHECK(f.get_double("count") == 1);
+    CHECK(f.get_double("sum") == 2.5);
+
+    auto v = f.get_double_array("values");
+    auto c = f.get_double_array("coverage");
+    CHECK(std::vector<double>(v.data, v.data + v.size) == std::vector<double>{ 1, 2, 3, 4 });
+    CHECK(std::vector<double>(c.data, c.data + c.size) == std::vector<double>{ 0.25, 0.25, 0.25, 0.25 });
+
+    // weighted operations are computed on the finer grid
+    CHECK(f.get_double("weighted_sum") == 10);
+}
+
+TEMPLATE_TEST_CASE("cells of a coarse raster are not divided between chunks", "[processor]", FeatureSequentialProcessor, RasterSequentialProcessor)
+{
+    GEOSContextHandle_t context = init_geos();
+
+    Box extent{ 0, 0, 6, 6 };
+
+    Matrix<double> values{ { { 1, 2, 3 },
+                             { 4, 5, 6 },
+                             { 7, 8, 9 } } };
+    MemoryRasterSource value_src(std::make_unique<Raster<double>>(std::move(values), extent));
+    MemoryRasterSource fine_src(std::make_unique<Raster<double>>(Matrix<double>{ 6, 6, 1.0 }, extent));
+
+    WKTFeatureSource ds;
+    MapFeature mf;
+    mf.set("fid", "1");
+    // covers one quarter of each corner cell and one half of each edge cell of the value raster
+    mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((1 1, 5 1, 5 5, 1 5, 1 1))")));
+    ds.add_feature(std::move(mf));
+
+    TestWriter writer;
+
+    TestType processor(ds, writer);
+    // chunks are aligned with the fine raster used by the first operation
+    auto fine_count = Operation::create("count", "fine_count", &fine_src, nullptr);
+    auto count = Operation::create("count", "count", &value_src, nullptr);
+    auto mean = Operation::create("mean", "mean", &value_src, nullptr);
+    auto cov = Operation::create("coverage", "coverage", &value_src, nullptr);
+    processor.add_operation(*fine_count);
+    processor.add_operation(*count);
+    processor.add_operation(*mean);
+    processor.add_operation(*cov);
+
+    SECTION("chunk boundaries are aligned with the cells of the coarse raster")
+    {
+        processor.set_max_cells_in_memory(12);
+        processor.process();
+
+        const MapFeature& f = writer.m_feature;
+
+        CHECK(f.get_double("fine_count") == 16);
+        CHECK(f.get_double("count") == 4);
+        CHECK(f.get_double("mean") == 5);
+
+        auto c = f.get_double_array("coverage");
+        CHECK(std::vector<double>(c.data, c.data + c.size) == std::vector<double>{ 0.25, 0.5, 0.25, 0.5, 1, 0.5, 0.25, 0.5, 0.25 });
+    }
+
+    SECTION("coverage is not aggregated if chunks are too small to be aligned")
+    {
+        processor.set_max_cells_in_memory(6);
+        processor.process();
+
+        const MapFeature& f = writer.m_feature;
+
+        // each cell of the fine grid is passed once, with its full coverage
+        CHECK(f.get_double("fine_count") == 16);
+        CHECK(f.get_double("count") == 16);
+        CHECK(f.get_double("mean") == 5);
+
+        auto c = f.get_double_array("coverage");
+        CHECK(std::vector<double>(c.data, c.data + c.size) == std::vector<double>(16, 1.0));
+    }
+}
+
+class TransformedRasterSource : public MemoryRasterSource
+{
+  public:
+    TransformedRasterSource(RasterVariant r, const AffineTransform& transform)
+      : MemoryRasterSource(std::move(r))
+      , m_transform(transform)
+    {
+    }
+
+    const AffineTransform* transform() const override
+    {
+        return &m_transform;
+    }
+
+  private:
+    AffineTransform m_transform;
+};
+
+TEMPLATE_TEST_CASE("features are transformed into the pixel space of a rotated raster", "[processor]", FeatureSequentialProcessor, RasterSequentialProcessor)
+{
+    GEOSContextHandle_t context = init_geos();
+
+    Box pixels{ 0, 0, 2, 2 };
+
+    Matrix<double> values{ { { 1, 2 },
+                             { 3, 4 } } };
+    auto value_rast = std::make_unique<Raster<double>>(std::move(values), pixels);
+
+    std::string wkt;
+    std::vector<double> expected_values;
+    std::vector<double> expected_x;
+    std::vector<double> expected_y;
+    double gt[6];
+
+    SECTION("south-up raster")
+    {
+        // row 0 covers 0 <= y <= 1
+        double south_up[6] = { 0, 1, 0, 0, 0, 1 };
+        std::copy(std::begin(south_up), std::end(south_up), gt);
+
+        wkt = "POLYGON ((0 0, 2 0, 2 1, 0 1, 0 0))";
+        expected_values = { 1, 2 };
+        expected_x = { 0.5, 1.5 };
+        expected_y = { 0.5, 0.5 };
+    }
+
+    SECTION("rotated raster")
+    {
+        // rows increase to the east and columns to the north
+        double rotated[6] = { 10, 0, 1, 20, 1, 0 };
+        std::copy(std::begin(rotated), std::end(rotated), gt);
+
+        wkt = "POLYGON ((10 20, 12 20, 12 21, 10 21, 10 20))";
+        expected_values = { 1, 3 };
+        expected_x = { 10.5, 11.5 };
+        expected_y = { 20.5, 20.5 };
+    }
+
+    TransformedRasterSource value_src(std::move(value_rast), AffineTransform::from_geotransform(gt, 2));
+
+    WKTFeatureSource ds;
+    MapFeature mf;
+    mf.set("fid", "1");
+    mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, wkt.c_str())));
+    ds.add_feature(std::move(mf));
+
+    TestWriter writer;
+
+    TestType processor(ds, writer);
+    auto sum = Operation::create("sum", "sum", &value_src, nullptr);
+    auto vals = Operation::create("values", "values", &value_src, nullptr);
+    auto center_x = Operation::create("center_x", "center_x", &value_src, nullptr);
+    auto center_y = Operation::create("center_y", "center_y", &value_src, nullptr);
+    processor.add_operation(*sum);
+    processor.add_operation(*vals);
+    processor.add_operation(*center_x);
+    processor.add_operation(*center_y);
+    processor.process();
+
+    const MapFeature& f = writer.m_feature;
+
+    CHECK(f.get_double("sum") == std::accumulate(expected_values.begin(), expected_values.end(), 0.0));
+
+    auto v = f.get_double_array("values");
+    auto x = f.get_double_array("center_x");
+    auto y = f.get_double_array("center_y");
+    CHECK(std::vector<double>(v.data, v.data + v.size) == expected_values);
+    CHECK(std::vector<double>(x.data, x.data + x.size) == expected_x);
+    CHECK(std::vector<double>(y.data, y.data + y.size) == expected_y);
+}
+
+TEST_CASE("unsupported inputs are rejected with a rotated raster", "[processor]")
+{
+    GEOSContextHandle_t context = init_geos();
+
+    double gt[6] = { 10, 0, 1, 20, 1, 0 };
+    auto value_rast = std::make_unique<Raster<double>>(Matrix<double>{ 2, 2, 1.0 }, Box{ 0, 0, 2, 2 });
+    TransformedRasterSource value_src(std::move(value_rast), AffineTransform::from_geotransform(gt, 2));
+
+    WKTFeatureSource ds;
+    TestWriter writer;
+    FeatureSequentialProcessor processor(ds, writer);
+
+    SECTION("linear geometries")
+    {
+        MapFeature mf;
+        mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "LINESTRING (10 20, 12 22)")));
+        ds.add_feature(std::move(mf));
+
+        auto sum = Operation::create("sum", "sum", &value_src, nullptr);
+        processor.add_operation(*sum);
+
+        CHECK_THROWS_WITH(processor.process(), Catch::Contains("Linear geometries"));
+    }
+
+    SECTION("area-based coverage weights")
+    {
+        auto sum = Operation::create("sum", "sum", &value_src, nullptr, { { "coverage_weight", "area_cartesian" } });
+        processor.add_operation(*sum);
+
+        CHECK_THROWS_WITH(processor.process(), Catch::Contains("cell area"));
+    }
+}
+
+class ShiftReprojection : public Reprojection
+{
+  public:
+    ShiftReprojection(double dx, double dy)
+      : m_dx(dx)
+      , m_dy(dy)
+    {
+    }
+
+    using Reprojection::apply;
+
+    void apply(double& x, double& y) const override
+    {
+        x += m_dx;
+        y += m_dy;
+    }
+
+  private:
+    double m_dx;
+    double m_dy;
+};
+
+TEMPLATE_TEST_CASE("features are reprojected to the CRS of the rasters", "[processor]", FeatureSequentialProcessor, RasterSequentialProcessor)
+{
+    GEOSContextHandle_t context = init_geos();
+
+    Matrix<double> values{ { { 1, 2, 3 },
+                             { 4, 5, 6 },
+                             { 7, 8, 9 } } };
+    auto value_rast = std::make_unique<Raster<double>>(std::move(values), Box{ 100, 200, 103, 203 });
+    MemoryRasterSource value_src(std::move(value_rast));
+    value_src.set_reprojection(std::make_shared<ShiftReprojection>(100, 200));
+
+    WKTFeatureSource ds;
+    MapFeature mf;
+    mf.set("fid", "1");
+    // covers the lower-left 2x2 cells of the raster after reprojection
+    mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((0 0, 2 0, 2 2, 0 2, 0 0))")));
+    ds.add_feature(std::move(mf));
+
+    TestWriter writer;
+
+    TestType processor(ds, writer);
+    processor.include_geometry();
+    auto sum = Operation::create("sum", "sum", &value_src, nullptr);
+    auto center_x = Operation::create("min_center_x", "min_center_x", &value_src, nullptr);
+    processor.add_operation(*sum);
+    processor.add_operation(*center_x);
+    processor.process();
+
+    const MapFeature& f = writer.m_feature;
+
+    CHECK(f.get_double("sum") == 4 + 5 + 7 + 8);
+    // cell coordinates are reported in the CRS of the raster
+    CHECK(f.get_double("min_center_x") == 100.5);
+
+    // output geometry is not reprojected
+    auto expected_geom = GEOSGeom_read_r(context, "POLYGON ((0 0, 2 0, 2 2, 0 2, 0 0))");
+    CHECK(GEOSEquals_r(context, f.geometry(), expected_geom.get()));
+}
+
+TEMPLATE_TEST_CASE("rasters with different CRS are processed in one pass", "[processor]", FeatureSequentialProcessor, RasterSequentialProcessor)
+{
+    GEOSContextHandle_t context = init_geos();
+
+    Matrix<double> values1{ { { 1, 2 },
+                              { 3, 4 } } };
+    MemoryRasterSource src1(std::make_unique<Raster<double>>(std::move(values1), Box{ 0, 0, 2, 2 }));
+
+    Matrix<double> values2{ { { 1, 2 },
+                              { 3, 4 } } };
+    MemoryRasterSource src2(std::make_unique<Raster<double>>(std::move(values2), Box{ 0, 0, 2, 2 }));
+    src2.set_reprojection(std::make_shared<ShiftReprojection>(1, 1));
+
+    WKTFeatureSource ds;
+    MapFeature mf;
+    mf.set("fid", "1");
+    mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((0 0, 1 0, 1 1, 0 1, 0 0))")));
+    ds.add_feature(std::move(mf));
+
+    TestWriter writer;
+    TestType processor(ds, writer);
+
+    auto sum1 = Operation::create("sum", "sum1", &src1, nullptr);
+    auto sum2 = Operation::create("sum", "sum2", &src2, nullptr);
+    processor.add_operation(*sum1);
+    processor.add_operation(*sum2);
+    processor.process();
+
+    const MapFeature& f = writer.m_feature;
+
+    // lower-left cell of the first raster
+    CHECK(f.get_double("sum1") == 3);
+    // upper-right cell of the second raster, after the feature is shifted
+    CHECK(f.get_double("sum2") == 2);
+}
+
+TEMPLATE_TEST_CASE("operations on rasters with unrelated grids are computed in one pass", "[processor]", FeatureSequentialProcessor, RasterSequentialProcessor)
+{
+    GEOSContextHandle_t context = init_geos();
+
+    Matrix<double> fine_values{ { { 1, 2, 3 },
+                                  { 4, 5, 6 },
+                                  { 7, 8, 9 } } };
+    MemoryRasterSource fine_src(std::make_unique<Raster<double>>(std::move(fine_values), Box{ 0, 0, 3, 3 }));
+
+    // resolution is not an integer multiple of the other raster
+    MemoryRasterSource coarse_src(std::make_unique<Raster<double>>(Matrix<double>{ 2, 2, 1.0 }, Box{ 0, 0, 2.8, 2.8 }));
+
+    WKTFeatureSource ds;
+    MapFeature mf;
+    mf.set("fid", "1");
+    mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((0 0, 2 0, 2 2, 0 2, 0 0))")));
+    ds.add_feature(std::move(mf));
+    MapFeature mf2;
+    mf2.set("fid", "2");
+    mf2.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((10 10, 11 10, 11 11, 10 11, 10 10))")));
+    ds.add_feature(std::move(mf2));
+
+    std::vector<MapFeature> written;
+    VectorWriter writer(written);
+
+    TestType processor(ds, writer);
+    processor.include_col("fid");
+
+    auto fine_sum = Operation::create("sum", "fine_sum", &fine_src, nullptr);
+    auto fine_count = Operation::create("count", "fine_count", &fine_src, nullptr);
+    auto coarse_count = Operation::create("count", "coarse_count", &coarse_src, nullptr);
+    processor.add_operation(*fine_sum);
+    processor.add_operation(*fine_count);
+    processor.add_operation(*coarse_count);
+    processor.process();
+
+    REQUIRE(written.size() == 2);
+
+    const MapFeature& f = written[0].get_string("fid") == "1" ? written[0] : written[1];
+    const MapFeature& outside = written[0].get_string("fid") == "1" ? written[1] : written[0];
+
+    CHECK(f.get_double("fine_sum") == 4 + 5 + 7 + 8);
+    CHECK(f.get_double("fine_count") == 4);
+    // coverage is computed separately on the grid of the coarse raster
+    CHECK(f.get_double("coarse_count") == Approx(4 / (1.4 * 1.4)));
+
+    CHECK(outside.get_double("fine_count") == 0);
+    CHECK(outside.get_double("coarse_count") == 0);
+}
+
+TEST_CASE("ProcessingPlan::make_plans groups operations by grid", "[processor]")
+{
+    MemoryRasterSource fine_src(std::make_unique<Raster<double>>(Matrix<double>{ 4, 4, 1.0 }, Box{ 0, 0, 4, 4 }));
+    fine_src.set_name("fine");
+    MemoryRasterSource coarse_src(std::make_unique<Raster<double>>(Matrix<double>{ 2, 2, 1.0 }, Box{ 0, 0, 4, 4 }));
+    coarse_src.set_name("coarse");
+    MemoryRasterSource unrelated_src(std::make_unique<Raster<double>>(Matrix<double>{ 3, 3, 1.0 }, Box{ 0, 0, 2.1, 2.1 }));
+    unrelated_src.set_name("unrelated");
+    MemoryRasterSource reprojected_src(std::make_unique<Raster<double>>(Matrix<double>{ 4, 4, 1.0 }, Box{ 0, 0, 4, 4 }));
+    reprojected_src.set_name("reprojected");
+    reprojected_src.set_reprojection(std::make_shared<ShiftReprojection>(1, 1));
+
+    std::vector<std::unique_ptr<Operation>> ops;
+    ops.push_back(Operation::create("mean", "fine_mean", &fine_src, nullptr));
+    ops.push_back(Operation::create("mean", "unrelated_mean", &unrelated_src, nullptr));
+    ops.push_back(Operation::create("mean", "coarse_mean", &coarse_src, nullptr));
+    ops.push_back(Operation::create("mean", "reprojected_mean", &reprojected_src, nullptr));
+
+    StatsRegistry reg;
+    for (const auto& op : ops) {
+        reg.prepare(*op);
+    }
+
+    auto plans = ProcessingPlan::make_plans(ops, reg, DEFAULT_GRID_COMPAT_TOL);
+
+    REQUIRE(plans.size() == 3);
+    CHECK(plans[0].stats_operations() == std::vector<const Operation*>{ ops[0].get(), ops[2].get() });
+    CHECK(plans[0].grid() == fine_src.grid());
+    CHECK(plans[1].stats_operations() == std::vector<const Operation*>{ ops[1].get() });
+    CHECK(plans[2].stats_operations() == std::vector<const Operation*>{ ops[3].get() });
+
+    CHECK(!plans[0].same_coordinates(plans[2]));
+    CHECK(plans[0].same_coordinates(plans[1]));
+
+    // a single plan cannot be made for rasters in different CRS
+    CHECK_THROWS_WITH(ProcessingPlan(ops, reg, DEFAULT_GRID_COMPAT_TOL), Catch::Contains("coordinate reference system"));
+}
+
+TEMPLATE_TEST_CASE("include_col and include_geom work as expected", "[processor]", FeatureSequentialProcessor, RasterSequentialProcessor)
+{
+    GEOSContextHandle_t context = init_geos();
+
+    Grid<bounded_extent> ex{ { 0, 0, 3, 3 }, 1, 1 }; // 3x3 grid
+    Matrix<double> values{ { { 1, 2, 3 },
+                             { 4, 5, 6 },
+                             { 7, 8, 9 } } };
+    auto value_rast = std::make_unique<Raster<double>>(std::move(values), ex.extent());
+    MemoryRasterSource value_src(std::move(value_rast));
+
+    WKTFeatureSource ds;
+    MapFeature mf;
+    mf.set("fid", "15");
+    mf.set("type", 13);
+    mf.set_geometry(geos_ptr(context, GEOSGeomFromWKT_r(context, "POLYGON ((0 0, 2 0, 2 2, 0 2, 0 0))")));
+    ds.add_feature(std::move(mf));
+
+    TestWriter writer;
+
+    TestType processor(ds, writer);
+    auto count = Operation::create("count", "count", &value_src, nullptr);
+    processor.add_operation(*count);
+    processor.include_col("fid");
+    processor.include_col("type");
+    processor.include_geometry();
+    processor.process();
+
+    ds.reset();
+    ds.next();
+
+    const MapFeature& f = writer.m_feature;
+    CHECK(f.get_double("count") == 4.0);
+    CHECK(f.get_string("fid") == "15");
+    CHECK(f.get_int("type") == 13);
+    CHECK(GEOSEquals_r(context, f.geometry(), ds.feature().geometry()) == 1);
+}
+
+TEST_CASE("Operation arguments", "[operation]")
+{
+    MemoryRasterSource mrs{ std::make_unique<Raster<float>>(Raster<float>::make_empty()) };
+
+    SECTION("successful arg parsing")
+    {
+        Operation::ArgMap args{ { "q", "0.05" } };
+
+        auto op = Operation::create("quantile", "fizz", &mrs, nullptr, args);
+        CHECK(op->name == "fizz_5");
+
+        // args are not modified
+        CHECK(args.find("q") != args.end());
+    }
+
+    SECTION("error if not all args are consumed")
+    {
+        Operation::ArgMap args{ { "q", "0.05" }, { "qq", "0.15" } };
+        CHECK_THROWS_WITH(Operation::create("quantile", "quantile", &mrs, nullptr, args), Catch::StartsWith("Unexpected argument"));
+
+        // args are not modified
+        CHECK(args.find("q") != args.end());
+        CHECK(args.find("qq") != args.end());
+    }
+
+    SECTION("error if arg cannot be parsed")
+    {
+        Operation::ArgMap args{ { "q", "chicken" } };
+        CHECK_THROWS_WITH(Operation::create("quantile", "quantile", &mrs, nullptr, args), Catch::StartsWith("Failed to parse"));
+    }
+
+    SECTION("error if arg is invalid")
+    {
+        Operation::ArgMap args{ { "q", "5" } };
+        CHECK_THROWS_WITH(Operation::create("quantile", "quantile", &mrs, nullptr, args), Catch::Contains("must be between 0 and 1"));
+    }
+
+    SECTION("error if required arg is missing")
     {
         Operation::ArgMap args;
         CHECK_THROWS_WITH(Operation::create("quantile", "quantile", &mrs, nullptr, args), Catch::StartsWith("Missing required argument"));
     }
 
+    SECTION("approximate quantiles use a sketch instead of a histogram")
+    {
+        Operation::ArgMap args{ { "q", "0.25" }, { "approx", "true" }, { "compression", "500" } };
+
+        auto op = Operation::create("quantile", "quantile", &mrs, nullptr, args);
+        CHECK(op->name == "quantile_25");
+        CHECK(op->requires_quantile_sketch());
+        CHECK(op->quantile_sketch_compression() == 500);
+        CHECK(!op->requires_histogram());
+
+        auto median = Operation::create("median", "median", &mrs, nullptr, { { "approx", "true" } });
+        CHECK(median->requires_quantile_sketch());
+        CHECK(!median->requires_histogram());
+    }
+
+    SECTION("error if compression is specified for an exact quantile")
+    {
+        Operation::ArgMap args{ { "q", "0.25" }, { "compression", "500" } };
+        CHECK_THROWS_WITH(Operation::create("quantile", "quantile", &mrs, nullptr, args), Catch::StartsWith("Unexpected argument"));
+    }
+
+    SECTION("histogram bins are specified by edges or by bins, min, and max")
+    {
+        CHECK_THROWS_WITH(Operation::create("histogram", "histogram", &mrs, nullptr, { { "bins", "5" } }), Catch::StartsWith("Missing required argument"));
+        CHECK_THROWS_WITH(Operation::create("histogram", "histogram", &mrs, nullptr, { { "edges", "1:2:3" }, { "bins", "5" } }), Catch::Contains("either edges or bins"));
+        CHECK_THROWS_WITH(Operation::create("histogram", "histogram", &mrs, nullptr, { { "edges", "1:3:2" } }), Catch::Contains("strictly increasing"));
+        CHECK_THROWS_WITH(Operation::create("histogram", "histogram", &mrs, nullptr, { { "bins", "0" }, { "min", "0" }, { "max", "1" } }), Catch::Contains("at least one bin"));
+        CHECK_THROWS_WITH(Operation::create("histogram", "histogram", &mrs, nullptr, { { "bins", "2" }, { "min", "1" }, { "max", "1" } }), Catch::Contains("max greater than min"));
+
+        auto op = Operation::create("histogram", "histogram", &mrs, nullptr, { { "bins", "4" }, { "min", "0" }, { "max", "1" } });
+        REQUIRE(op->binned_histogram() != nullptr);
+        CHECK(op->binned_histogram()->edges() == std::vector<double>{ 0, 0.25, 0.5, 0.75, 1 });
+        CHECK(op->result_type() == Feature::ValueType::DOUBLE_ARRAY);
+    }
+
+    SECTION("histograms with nearly equal edges do not share bins")
+    {
+        auto a = Operation::create("histogram", "a", &mrs, nullptr, { { "edges", "0:1000000:2000000" } });
+        auto b = Operation::create("histogram", "b", &mrs, nullptr, { { "edges", "0:1000001:2000000" } });
+
+        CHECK(a->key() != b->key());
+
+        StatsRegistry reg;
+        reg.prepare(*a);
+        reg.prepare(*b);
+
+        CHECK(reg.options(*a).binned_histogram->edges() == std::vector<double>{ 0, 1000000, 2000000 });
+        CHECK(reg.options(*b).binned_histogram->edges() == std::vector<double>{ 0, 1000001, 2000000 });
+    }
+
     SECTION("error if default value out of range (int)")
     {
         Operation::ArgMap args{ { "default_value", "128" } };
@@ -384,6 +384,48 @@ TEST_CASE("Expanded view")
     CHECK(rv(19, 19) == rast(9, 14));
 }
 
+TEST_CASE("Materialized view has the same values as the view")
+{
+    Box rast_box{ 5, 10, 20, 20 };
+    Raster<int> rast{ Grid<bounded_extent>{ rast_box, 1, 1 } };
+    fill_sequential(rast);
+    rast.set_nodata(-1);
+
+    auto view_box = GENERATE(Box{ 5, 10, 20, 20 },  // same extent
+                             Box{ 0, 0, 30, 30 },   // expanded in all directions
+                             Box{ 7, 12, 11, 17 },  // contained within raster
+                             Box{ 15, 15, 25, 25 }, // partially overlapping
+                             Box{ 30, 30, 40, 40 }  // disjoint
+    );
+    auto view_res = GENERATE(1.0, 0.5, 0.25);
+
+    CAPTURE(view_box);
+    CAPTURE(view_res);
+
+    RasterView<int> rv{ rast, Grid<bounded_extent>{ view_box, view_res, view_res } };
+    auto materialized = rv.materialize();
+
+    CHECK(materialized->grid() == rv.grid());
+    CHECK(materialized->has_nodata());
+    CHECK(materialized->nodata() == -1);
+    CHECK(*materialized == rv);
+}
+
+TEST_CASE("Materialized view on empty raster")
+{
+    Raster<double> rast{ Grid<bounded_extent>::make_empty() };
+
+    RasterView<double> rv{ rast, Grid<bounded_extent>{ { -10, -10, 10, 10 }, 0.5, 0.5 } };
+    auto materialized = rv.materialize();
+
+    CHECK(materialized->rows() == rv.rows());
+    CHECK(materialized->cols() == rv.cols());
+    CHECK(std::isnan((*materialized)(24, 24)));
+
+    RasterView<double> empty_view{ rast, Grid<bounded_extent>::make_empty() };
+    CHECK(empty_view.materialize()->size() == 0);
+}
+
 TEST_CASE("Get method accesses value and tells us if it was defined")
 {
     float nan = std::numeric_limits<float>::quiet_NaN();
@@ -36,3 +36,82 @@ TEST_CASE("Spherical area raster returns pixel area")
 
     CHECK(std::abs((areas(4, 3) - postgis_area) / postgis_area) < 0.002);
 }
+
+TEST_CASE("Ellipsoidal area raster returns pixel area")
+{
+    Grid<bounded_extent> g{ { 0, 45, 10, 55 }, 1.0, 1.0 };
+
+    EllipsoidalAreaRaster<double> areas(g, AreaUnit::M2);
+    EllipsoidalAreaRaster<double> areas_km2(g, AreaUnit::KM2);
+
+    // The PostGIS result differs slightly because the northern and southern edges
+    // of the polygon are geodesics rather than parallels.
+    // SELECT ST_Area('POLYGON ((3 50, 4 50, 4 51, 3 51, 3 50))'::geography);
+    constexpr double postgis_area = 7892061583.206543;
+
+    CHECK(areas(4, 3) == Approx(postgis_area).epsilon(1e-4));
+    CHECK(areas_km2(4, 3) == Approx(areas(4, 3) * 1e-6));
+
+    // Total surface area of the WGS84 ellipsoid
+    CHECK(360 * LatitudeBandAreas::band_area(LatitudeBandAreas::Shape::WGS84, -90, 90) == Approx(510065621724088.0).epsilon(1e-9));
+}
+
+TEST_CASE("Latitude band areas of a grid are used by its subgrids")
+{
+    Grid<bounded_extent> full{ { -180, -90, 180, 90 }, 0.5, 0.5 };
+    auto sub = full.crop({ 10, 20.25, 20, 30 });
+    Grid<bounded_extent> offset{ { -180, -89.75, 180, 89.75 }, 0.5, 0.5 };
+
+    auto shape = LatitudeBandAreas::Shape::WGS84;
+    auto table = std::make_shared<const LatitudeBandAreas>(shape, full);
+
+    auto first_row = full.get_row(sub.y_for_row(0));
+    CHECK(table->row_offset(full) == 0u);
+    CHECK(table->row_offset(sub) == first_row);
+    CHECK(!table->row_offset(offset).has_value());
+    CHECK(!table->row_offset(Grid<bounded_extent>{ { 10, 20, 20, 30 }, 0.25, 0.25 }).has_value());
+
+    EllipsoidalAreaRaster<double> shared(sub, AreaUnit::M2, table);
+    EllipsoidalAreaRaster<double> computed(sub, AreaUnit::M2);
+    EllipsoidalAreaRaster<double> misaligned(offset, AreaUnit::M2, table);
+    SphericalAreaRaster<double> other_shape(sub, AreaUnit::M2, table);
+
+    for (std::size_t i = 0; i < sub.rows(); i++) {
+        CHECK(shared(i, 0) == (*table)[first_row + i] * sub.dx());
+        CHECK(shared(i, 0) == computed(i, 0));
+
+        double y = sub.y_for_row(i);
+        CHECK(other_shape(i, 0) == Approx(sub.dx() * LatitudeBandAreas::band_area(LatitudeBandAreas::Shape::SPHERE, y - 0.25, y + 0.25)));
+    }
+
+    for (std::size_t i = 0; i < offset.rows(); i++) {
+        double y = offset.y_for_row(i);
+        CHECK(misaligned(i, 0) == Approx(offset.dx() * LatitudeBandAreas::band_area(shape, y - 0.25, y + 0.25)));
+    }
+}
+
+TEST_CASE("Latitude band areas of a grid are used by coarser aligned grids")
+{
+    Grid<bounded_extent> full{ { -180, -90, 180, 90 }, 0.5, 0.5 };
+    Grid<bounded_extent> coarse{ { 10, 20, 20, 30 }, 2, 2 };
+    Grid<bounded_extent> shifted{ { 10, 20.5, 20, 30.5 }, 2, 2 };
+    Grid<bounded_extent> misaligned{ { 10, 20.25, 20, 30.25 }, 2, 2 };
+    Grid<bounded_extent> uneven{ { 10, 20, 20, 30.5 }, 2, 0.75 };
+
+    auto shape = LatitudeBandAreas::Shape::SPHERE;
+    auto table = std::make_shared<const LatitudeBandAreas>(shape, full);
+
+    CHECK(table->rows_per_row(coarse) == 4u);
+    CHECK(table->row_offset(coarse) == 120u);
+    CHECK(table->row_offset(shifted) == 119u);
+    CHECK(!table->row_offset(misaligned).has_value());
+    CHECK(!table->rows_per_row(uneven).has_value());
+    CHECK(!table->row_offset(uneven).has_value());
+
+    SphericalAreaRaster<double> shared(coarse, AreaUnit::KM2, table);
+    SphericalAreaRaster<double> computed(coarse, AreaUnit::KM2);
+
+    for (std::size_t i = 0; i < coarse.rows(); i++) {
+        CHECK(shared(i, 0) == Approx(computed(i, 0)).epsilon(1e-12));
+    }
+}
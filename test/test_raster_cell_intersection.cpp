@@ -669,3 +669,50 @@ TEST_CASE("Processing region incorporates overlapping area of all component boxe
 
     CHECK(processing_region(raster_extent, component_boxes) == raster_extent);
 }
+
+TEST_CASE("Coverage fractions can be aggregated to a coarser grid", "[raster-cell-intersection]")
+{
+    // Coverage grid begins one cell right of and below the origin of the coarse grid
+    Raster<float> coverage{ Matrix<float>{ { { 1, 1, 0.5 },
+                                              { 1, 1, 0.5 },
+                                              { 0.25, 0.25, 0 } } },
+                            Box{ 1, 0, 4, 3 } };
+
+    Grid<bounded_extent> coarse{ { 0, -2, 6, 4 }, 2, 2 };
+
+    Raster<float> aggregated = aggregate_coverage(coverage, coarse, true);
+
+    CHECK(aggregated.grid() == Grid<bounded_extent>{ { 0, 0, 4, 4 }, 2, 2 });
+
+    check_cell_intersections(aggregated, { { 0.25f, 0.375f },
+                                           { 0.3125f, 0.4375f } });
+}
+
+TEST_CASE("Fully covered cells have a coverage of exactly 1 after aggregation", "[raster-cell-intersection]")
+{
+    Raster<float> coverage{ Matrix<float>{ 6, 6, 1.0f }, Box{ 0, 0, 6, 6 } };
+
+    Raster<float> aggregated = aggregate_coverage(coverage, Grid<bounded_extent>{ { 0, 0, 6, 6 }, 3, 3 }, true);
+
+    check_cell_intersections(aggregated, { { 1, 1 },
+                                           { 1, 1 } });
+}
+
+TEST_CASE("Line lengths are summed when aggregated to a coarser grid", "[raster-cell-intersection]")
+{
+    Raster<float> lengths{ Matrix<float>{ { { 1, 0.5 },
+                                             { 0, 1.5 } } },
+                           Box{ 0, 0, 2, 2 } };
+
+    Raster<float> aggregated = aggregate_coverage(lengths, Grid<bounded_extent>{ { 0, 0, 2, 2 }, 2, 2 }, false);
+
+    check_cell_intersections(aggregated, { { 3 } });
+}
+
+TEST_CASE("Coverage cannot be aggregated to an incompatible grid", "[raster-cell-intersection]")
+{
+    Raster<float> coverage{ Matrix<float>{ 2, 2, 1.0f }, Box{ 0, 0, 2, 2 } };
+
+    CHECK_THROWS_WITH(aggregate_coverage(coverage, Grid<bounded_extent>{ { 0, 0, 3, 3 }, 1.5, 1.5 }, true),
+                      Catch::Contains("integer multiple"));
+}
@@ -1,11 +1,16 @@
 #include <cmath>
+#include <map>
+#include <random>
 #include <sstream>
 #include <valarray>
 
 #include "catch.hpp"
 
+#include "binned_histogram.h"
+#include "frequency_table.h"
 #include "geos_utils.h"
 #include "grid.h"
+#include "quantile_sketch.h"
 #include "raster_cell_intersection.h"
 #include "raster_stats.h"
 #include "variance.h"
@@ -524,6 +529,50 @@ TEST_CASE("Weighted quantile calculations are correct for unequally-weighted inp
     CHECK(wq.quantile(1.00) == Approx(100.4));
 }
 
+TEST_CASE("Quantile sketch approximates weighted quantiles")
+{
+    std::mt19937 gen(123);
+    std::normal_distribution<double> value_dist(10, 3);
+    std::uniform_real_distribution<double> weight_dist(0, 1);
+
+    WeightedQuantiles wq;
+    QuantileSketch sketch;
+    QuantileSketch a;
+    QuantileSketch b;
+
+    for (int i = 0; i < 100000; i++) {
+        double x = value_dist(gen);
+        double w = weight_dist(gen);
+
+        wq.process(x, w);
+        sketch.process(x, w);
+        (i % 2 == 0 ? a : b).process(x, w);
+    }
+
+    a.merge(b);
+
+    // Memory use is bounded by the compression parameter, not the number of inputs
+    CHECK(sketch.size() <= static_cast<std::size_t>(QuantileSketch::DEFAULT_COMPRESSION));
+    CHECK(a.size() <= static_cast<std::size_t>(QuantileSketch::DEFAULT_COMPRESSION));
+
+    CHECK(sketch.quantile(0) == wq.quantile(0));
+    CHECK(sketch.quantile(1) == wq.quantile(1));
+
+    for (double q : { 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99 }) {
+        CHECK(sketch.quantile(q) == Approx(wq.quantile(q)).margin(0.1));
+        CHECK(a.quantile(q) == Approx(wq.quantile(q)).margin(0.1));
+    }
+}
+
+TEST_CASE("Quantile sketch errors on invalid inputs")
+{
+    CHECK_THROWS(QuantileSketch(0));
+    CHECK_THROWS(QuantileSketch().process(5, -1));
+    CHECK_THROWS(QuantileSketch().process(3, std::numeric_limits<double>::infinity()));
+    CHECK_THROWS(QuantileSketch().quantile(1.1));
+    CHECK(std::isnan(QuantileSketch().quantile(0.5)));
+}
+
 TEST_CASE("Weighted quantile errors on invalid weights")
 {
     CHECK_THROWS(WeightedQuantiles().process(5, -1));
@@ -557,6 +606,104 @@ TEST_CASE("Weighted quantiles are appropriately refreshed")
     CHECK(wq.quantile(0.5) == 2.5);
 }
 
+TEST_CASE("Binned histogram assigns values to bins", "[stats]")
+{
+    BinnedHistogram edges({ 0, 1, 5, 10 });
+    CHECK(edges.size() == 3);
+    CHECK(edges.bin(-1) == std::nullopt);
+    CHECK(edges.bin(0) == 0u);
+    CHECK(edges.bin(0.999) == 0u);
+    CHECK(edges.bin(1) == 1u);
+    CHECK(edges.bin(7) == 2u);
+    CHECK(edges.bin(10) == 2u); // last bin is closed
+    CHECK(edges.bin(10.001) == std::nullopt);
+    CHECK(edges.bin(std::numeric_limits<double>::quiet_NaN()) == std::nullopt);
+
+    auto fixed = BinnedHistogram::fixed_width(0, 1, 10);
+    CHECK(fixed.size() == 10);
+    for (std::size_t i = 0; i < 10; i++) {
+        double lo = fixed.edges()[i];
+        double hi = fixed.edges()[i + 1];
+        CHECK(fixed.bin(lo) == i);
+        CHECK(fixed.bin(std::nextafter(hi, lo)) == i);
+    }
+    CHECK(fixed.bin(1) == 9u);
+
+    fixed.process(0.05, 0.5, 1.0);
+    fixed.process(0.05, 0.25, 0.75);
+    fixed.process(0.95, 1.0, 2.0);
+    fixed.process(3, 1.0, 2.0);
+
+    CHECK(fixed.counts() == std::vector<double>{ 0.75, 0, 0, 0, 0, 0, 0, 0, 0, 1.0 });
+    CHECK(fixed.weighted_counts() == std::vector<double>{ 1.75, 0, 0, 0, 0, 0, 0, 0, 0, 2.0 });
+}
+
+TEST_CASE("Binned histogram errors on invalid bins", "[stats]")
+{
+    CHECK_THROWS(BinnedHistogram({ 1 }));
+    CHECK_THROWS(BinnedHistogram({ 1, 1 }));
+    CHECK_THROWS(BinnedHistogram({ 0, std::numeric_limits<double>::infinity() }));
+    CHECK_THROWS(BinnedHistogram::fixed_width(0, 1, 0));
+    CHECK_THROWS(BinnedHistogram::fixed_width(1, 0, 5));
+}
+
+template<typename T>
+static std::map<T, int>
+to_map(const FrequencyTable<T, int>& table)
+{
+    std::map<T, int> ret;
+    for (const auto& entry : table) {
+        ret[entry.first] = entry.second;
+    }
+    return ret;
+}
+
+TEMPLATE_TEST_CASE("Frequency table records distinct values", "[stats]", std::int8_t, std::uint8_t, std::int16_t, std::uint16_t, std::int32_t, std::int64_t, std::uint64_t, float, double)
+{
+    FrequencyTable<TestType, int> table;
+    CHECK(table.empty());
+    CHECK(table.begin() == table.end());
+
+    std::vector<TestType> values{ 3, 5, 3, std::numeric_limits<TestType>::lowest(), std::numeric_limits<TestType>::max(), 0, 5, 3 };
+    std::map<TestType, int> expected;
+
+    for (const auto& v : values) {
+        table[v]++;
+        expected[v]++;
+    }
+
+    CHECK(table.size() == expected.size());
+    CHECK(to_map(table) == expected);
+
+    for (const auto& [value, count] : expected) {
+        REQUIRE(table.find(value) != nullptr);
+        CHECK(*table.find(value) == count);
+    }
+
+    CHECK(table.find(7) == nullptr);
+}
+
+TEST_CASE("Frequency table grows dense range in both directions", "[stats]")
+{
+    FrequencyTable<std::int32_t, int> table;
+    std::map<std::int32_t, int> expected;
+
+    for (std::int32_t v : { 100, 50, 5000, -20, 100, 70000, -32768, 123456789, 60000 }) {
+        table[v]++;
+        expected[v]++;
+    }
+
+    CHECK(table.size() == expected.size());
+    CHECK(to_map(table) == expected);
+
+    // values in the dense range are visited in ascending order
+    std::vector<std::int32_t> visited;
+    for (const auto& entry : table) {
+        visited.push_back(entry.first);
+    }
+    CHECK(std::is_sorted(visited.begin(), visited.begin() + 5));
+}
+
 TEST_CASE("min_coverage_frac is respected", "[stats]")
 {
     Grid<bounded_extent> extent{ { 0, 0, 2, 2 }, 1, 1 };